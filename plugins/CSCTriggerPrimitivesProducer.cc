@@ -15,13 +15,14 @@
  
 #include "L1Trigger/CSCTriggerPrimitives/plugins/CSCTriggerPrimitivesProducer.h"
 #include "L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesBuilder.h"
+#include "L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesStats.h"
 
 #include "DataFormats/Common/interface/Handle.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "Geometry/Records/interface/MuonGeometryRecord.h"
-#include "L1Trigger/CSCCommonTrigger/interface/CSCTriggerGeometry.h"
+#include "Geometry/CSCGeometry/interface/CSCGeometry.h"
 #include "CondFormats/DataRecord/interface/CSCBadChambersRcd.h"
 
 #include "DataFormats/CSCDigi/interface/CSCComparatorDigiCollection.h"
@@ -29,13 +30,15 @@
 #include "DataFormats/CSCDigi/interface/CSCALCTDigiCollection.h"
 #include "DataFormats/CSCDigi/interface/CSCCLCTDigiCollection.h"
 #include "DataFormats/CSCDigi/interface/CSCCorrelatedLCTDigiCollection.h"
+#include "DataFormats/MuonDetId/interface/CSCDetId.h"
+#include "DataFormats/MuonDetId/interface/MuonSubdetId.h"
 
 // Configuration via EventSetup
 #include "CondFormats/CSCObjects/interface/CSCDBL1TPParameters.h"
 #include "CondFormats/DataRecord/interface/CSCDBL1TPParametersRcd.h"
 
 
-CSCTriggerPrimitivesProducer::CSCTriggerPrimitivesProducer(const edm::ParameterSet& conf) : iev(0) {
+CSCTriggerPrimitivesProducer::CSCTriggerPrimitivesProducer(const edm::ParameterSet& conf) : iev(0), geometryCacheId_(0) {
 
   // if false, parameters will be read in from DB using EventSetup mechanism
   // else will use all parameters from the config file
@@ -45,62 +48,122 @@ CSCTriggerPrimitivesProducer::CSCTriggerPrimitivesProducer(const edm::ParameterS
   compDigiProducer_ = conf.getParameter<edm::InputTag>("CSCComparatorDigiProducer");
   checkBadChambers_ = conf.getUntrackedParameter<bool>("checkBadChambers", true);
 
-  lctBuilder_ = new CSCTriggerPrimitivesBuilder(conf); // pass on the conf
-
-  // register what this produces
-  produces<CSCALCTDigiCollection>();
-  produces<CSCCLCTDigiCollection>();
-  produces<CSCCLCTPreTriggerCollection>();
-  produces<CSCCorrelatedLCTDigiCollection>();
-  produces<CSCCorrelatedLCTDigiCollection>("MPCSORTED");
+  wireDigiToken_ = consumes<CSCWireDigiCollection>(wireDigiProducer_);
+  compDigiToken_ = consumes<CSCComparatorDigiCollection>(compDigiProducer_);
+
+  // If given, only the chambers in this collection (and, optionally, their
+  // neighbours) are run.
+  roiChambers_ = conf.getUntrackedParameter<edm::InputTag>("roiChambers", edm::InputTag());
+  if (!roiChambers_.label().empty())
+    roiToken_ = consumes<std::vector<DetId> >(roiChambers_);
+
+  // One builder per stream: all the emulator state lives in it.
+  lctBuilder_.reset(new CSCTriggerPrimitivesBuilder(conf)); // pass on the conf
+
+  // register what this produces; the builder skips the work needed only
+  // for the collections not requested
+  outputs_.alcts = conf.getUntrackedParameter<bool>("produceALCTs", true);
+  outputs_.clcts = conf.getUntrackedParameter<bool>("produceCLCTs", true);
+  outputs_.preTriggers = conf.getUntrackedParameter<bool>("producePreTriggers", true);
+  outputs_.lcts = conf.getUntrackedParameter<bool>("produceLCTs", true);
+  outputs_.mpcLCTs = conf.getUntrackedParameter<bool>("produceMPCLCTs", true);
+  lctBuilder_->setOutputs(outputs_);
+  if (outputs_.alcts) produces<CSCALCTDigiCollection>();
+  if (outputs_.clcts) produces<CSCCLCTDigiCollection>();
+  if (outputs_.preTriggers) produces<CSCCLCTPreTriggerCollection>();
+  if (outputs_.lcts) produces<CSCCorrelatedLCTDigiCollection>();
+  if (outputs_.mpcLCTs) produces<CSCCorrelatedLCTDigiCollection>("MPCSORTED");
+
+#ifdef CSCTP_INSTRUMENTATION
+  CSCTriggerPrimitivesStats::beginStream();
+#endif
 }
 
 CSCTriggerPrimitivesProducer::~CSCTriggerPrimitivesProducer() {
-  LogDebug("L1CSCTrigger")
-    << "deleting trigger primitives after " << iev << " events.";
-  delete lctBuilder_;
 }
 
-//void CSCTriggerPrimitivesProducer::beginRun(const edm::EventSetup& setup) {
-//}
+void CSCTriggerPrimitivesProducer::endStream() {
+  // The boards of each stream are reconfigured only when the IOV of the
+  // DB parameters changes; report how often that happened.
+  edm::LogInfo("L1CSCTrigger")
+    << "trigger primitives stream ended after " << iev << " events; "
+    << "configuration parameters were applied "
+    << lctBuilder_->numConfigUpdates() << " times.";
+
+  // The instrumentation counters are shared by all streams: the last one
+  // to end prints them.
+#ifdef CSCTP_INSTRUMENTATION
+  if (CSCTriggerPrimitivesStats::endStream())
+    edm::LogInfo("L1CSCTrigger") << CSCTriggerPrimitivesStats::summary();
+#endif
+}
+
+void CSCTriggerPrimitivesProducer::beginRun(const edm::Run& run,
+					    const edm::EventSetup& setup) {
+  updateGeometry(setup);
+}
+
+void CSCTriggerPrimitivesProducer::updateGeometry(const edm::EventSetup& setup) {
+  // Take a snapshot of the geometry for the boards, but only if it changed
+  // since it was last taken.  The geometry is handed to the builder of
+  // this stream directly; the process-wide CSCTriggerGeometry is not
+  // used, so streams changing geometry do not race.
+  const MuonGeometryRecord& geomRcd = setup.get<MuonGeometryRecord>();
+  const unsigned long long cacheId = geomRcd.cacheIdentifier();
+  if (cacheId == geometryCacheId_) return;
+
+  edm::ESHandle<CSCGeometry> h;
+  geomRcd.get(h);
+  lctBuilder_->setGeometry(h.product(), cacheId);
+  geometryCacheId_ = cacheId;
+}
 
 void CSCTriggerPrimitivesProducer::produce(edm::Event& ev,
 					   const edm::EventSetup& setup) {
 
-  LogDebug("L1CSCTrigger") << "start producing LCTs for event " << ++iev;
-
-  // Find the geometry (& conditions?) for this event & cache it in 
-  // CSCTriggerGeometry.
-  {
-    edm::ESHandle<CSCGeometry> h;
-    setup.get<MuonGeometryRecord>().get(h);
-    CSCTriggerGeometry::setGeometry(h);
+  // Counted outside LogDebug, which is compiled out in normal builds.
+  ++iev;
+  LogDebug("L1CSCTrigger") << "start producing LCTs for event " << iev;
+
+  // The geometry is normally taken in beginRun(); this only checks that
+  // its IOV did not change within the run.
+  updateGeometry(setup);
+
+  // Find conditions data for bad chambers; the builder only reads them
+  // when their IOV changes.
+  if (checkBadChambers_) {
+    const CSCBadChambersRcd& badRcd = setup.get<CSCBadChambersRcd>();
+    edm::ESHandle<CSCBadChambers> pBadChambers;
+    badRcd.get(pBadChambers);
+    lctBuilder_->setBadChambers(pBadChambers.product(),
+				badRcd.cacheIdentifier());
   }
 
-  // Find conditions data for bad chambers.
-  edm::ESHandle<CSCBadChambers> pBadChambers;
-  setup.get<CSCBadChambersRcd>().get(pBadChambers);
-
   // If !debugParameters then get config parameters using EventSetup mechanism.
-  // This must be done in produce() for every event and not in beginJob() 
-  // (see mail from Jim Brooke sent to hn-cms-L1TrigEmulator on July 30, 2007).
+  // This must be checked in produce() for every event and not in beginJob()
+  // (see mail from Jim Brooke sent to hn-cms-L1TrigEmulator on July 30, 2007),
+  // but the boards are only reconfigured when the IOV of the record changes.
   if (!debugParameters_) {
+    const CSCDBL1TPParametersRcd& confRcd = setup.get<CSCDBL1TPParametersRcd>();
     edm::ESHandle<CSCDBL1TPParameters> conf;
-    setup.get<CSCDBL1TPParametersRcd>().get(conf);
+    confRcd.get(conf);
     if (conf.product() == 0) {
       edm::LogError("L1CSCTPEmulatorConfigError")
         << "+++ Failed to find a CSCDBL1TPParametersRcd in EventSetup! +++\n"
         << "+++ Cannot continue emulation without these parameters +++\n";
       return;
     }
-    lctBuilder_->setConfigParameters(conf.product());
+    if (lctBuilder_->setConfigParameters(conf.product(),
+					 confRcd.cacheIdentifier()))
+      LogDebug("L1CSCTrigger")
+	<< "applied new configuration parameters in event " << iev;
   }
   
   // Get the collections of comparator & wire digis from event.
   edm::Handle<CSCComparatorDigiCollection> compDigis;
   edm::Handle<CSCWireDigiCollection>       wireDigis;
-  ev.getByLabel(compDigiProducer_.label(), compDigiProducer_.instance(), compDigis);
-  ev.getByLabel(wireDigiProducer_.label(), wireDigiProducer_.instance(), wireDigis);
+  ev.getByToken(compDigiToken_, compDigis);
+  ev.getByToken(wireDigiToken_, wireDigis);
 
   // Create empty collections of ALCTs, CLCTs, and correlated LCTs upstream
   // and downstream of MPC.
@@ -124,20 +187,40 @@ void CSCTriggerPrimitivesProducer::produce(edm::Event& ev,
       << " requested in configuration, but not found in the event..."
       << " Skipping production of CSC TP digis +++\n";
   }
+  // Restrict the emulation to the region of interest, if any; without a
+  // valid list of chambers, none is run.
+  if (!roiChambers_.label().empty()) {
+    edm::Handle<std::vector<DetId> > roiIds;
+    ev.getByToken(roiToken_, roiIds);
+    std::vector<CSCDetId> chambers;
+    if (roiIds.isValid()) {
+      for (std::vector<DetId>::const_iterator id = roiIds->begin();
+	   id != roiIds->end(); ++id) {
+	if (id->det() == DetId::Muon && id->subdetId() == MuonSubdetId::CSC)
+	  chambers.push_back(CSCDetId(*id).chamberId());
+      }
+    }
+    else {
+      edm::LogWarning("L1CSCTPEmulatorNoInputCollection")
+	<< "+++ Warning: Collection of region-of-interest chambers with label "
+	<< roiChambers_.label()
+	<< " requested in configuration, but not found in the event..."
+	<< " No chamber is run +++\n";
+    }
+    lctBuilder_->setRegionOfInterest(chambers);
+  }
+
   // Fill output collections if valid input collections are available.
   if (wireDigis.isValid() && compDigis.isValid()) {   
-    const CSCBadChambers* temp = checkBadChambers_ ? pBadChambers.product() : new CSCBadChambers;
-    lctBuilder_->build(temp,
-		       wireDigis.product(), compDigis.product(),
+    lctBuilder_->setTraceEvent(ev.id().event());
+    lctBuilder_->build(wireDigis.product(), compDigis.product(),
 		       *oc_alct, *oc_clct, *oc_pretrig, *oc_lct, *oc_sorted_lct);
-    if (!checkBadChambers_)
-      delete temp;
   }
 
-  // Put collections in event.
-  ev.put(oc_alct);
-  ev.put(oc_clct);
-  ev.put(oc_pretrig);
-  ev.put(oc_lct);
-  ev.put(oc_sorted_lct,"MPCSORTED");
+  // Put requested collections in event.
+  if (outputs_.alcts) ev.put(oc_alct);
+  if (outputs_.clcts) ev.put(oc_clct);
+  if (outputs_.preTriggers) ev.put(oc_pretrig);
+  if (outputs_.lcts) ev.put(oc_lct);
+  if (outputs_.mpcLCTs) ev.put(oc_sorted_lct,"MPCSORTED");
 }
@@ -15,6 +15,10 @@
  * stubs, or LCTs): anode LCTs (ALCTs), cathode LCTs (CLCTs), correlated
  * LCTs at TMB, and correlated LCTs at MPC.
  *
+ * This is a stream module: the framework creates one producer, and hence
+ * one CSCTriggerPrimitivesBuilder with its own set of boards, per stream,
+ * so that events in different streams are emulated concurrently.
+ *
  * \author Slava Valuev, UCLA.
  *
  * $Id: CSCTriggerPrimitivesProducer.h,v 1.4.2.1 2012/05/16 00:31:24 khotilov Exp $
@@ -22,31 +26,53 @@
  */
 
 #include <FWCore/Framework/interface/Frameworkfwd.h>
-#include <FWCore/Framework/interface/EDProducer.h>
+#include <FWCore/Framework/interface/stream/EDProducer.h>
 #include <FWCore/Framework/interface/Event.h>
+#include <FWCore/Framework/interface/Run.h>
 #include <FWCore/ParameterSet/interface/ParameterSet.h>
 #include <FWCore/Utilities/interface/InputTag.h>
+#include <FWCore/Utilities/interface/EDGetToken.h>
+
+#include <DataFormats/CSCDigi/interface/CSCComparatorDigiCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCWireDigiCollection.h>
+#include <DataFormats/DetId/interface/DetId.h>
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesBuilder.h>
 
-class CSCTriggerPrimitivesBuilder;
+#include <memory>
+#include <vector>
 
-class CSCTriggerPrimitivesProducer : public edm::EDProducer
+class CSCTriggerPrimitivesProducer : public edm::stream::EDProducer<>
 {
  public:
   explicit CSCTriggerPrimitivesProducer(const edm::ParameterSet&);
   ~CSCTriggerPrimitivesProducer();
 
-  //virtual void beginRun(const edm::EventSetup& setup);
+  virtual void beginRun(const edm::Run&, const edm::EventSetup&);
   virtual void produce(edm::Event&, const edm::EventSetup&);
+  virtual void endStream();
 
  private:
-  int iev; // event number
+  int iev; // number of events seen by this stream
+  // takes the CSC geometry if it changed since it was last taken
+  void updateGeometry(const edm::EventSetup& setup);
   edm::InputTag compDigiProducer_;
   edm::InputTag wireDigiProducer_;
+  edm::EDGetTokenT<CSCComparatorDigiCollection> compDigiToken_;
+  edm::EDGetTokenT<CSCWireDigiCollection> wireDigiToken_;
+  // chambers to be run, if only a region of interest is to be emulated
+  edm::InputTag roiChambers_;
+  edm::EDGetTokenT<std::vector<DetId> > roiToken_;
   // swich to force the use of parameters from config file rather then from DB
   bool debugParameters_;
   // switch to for enabling checking against the list of bad chambers
   bool checkBadChambers_;
-  CSCTriggerPrimitivesBuilder* lctBuilder_;
+  // output collections, as passed on to the builder
+  CSCTriggerPrimitivesBuilder::Outputs outputs_;
+  // cache identifier of the MuonGeometryRecord last taken
+  unsigned long long geometryCacheId_;
+  // builder owned by this stream
+  std::unique_ptr<CSCTriggerPrimitivesBuilder> lctBuilder_;
 };
 
 #endif
@@ -17,6 +17,37 @@ cscTriggerPrimitiveDigis = cms.EDProducer("CSCTriggerPrimitivesProducer",
     # for SLHC studies we don't want bad chambers checks so far
     checkBadChambers = cms.untracked.bool(True),
 
+    # if True, TMBs of different chambers, and then MPC sorting of different
+    # sectors and BXs, are run concurrently; the output is the same as in
+    # the sequential mode
+    runParallel = cms.untracked.bool(False),
+
+    # if True, only TMBs of chambers having wire or comparator digis are run
+    sparseDispatch = cms.untracked.bool(False),
+
+    # if not empty, the wire and comparator digis of the chambers run are
+    # written to this file, for standalone replay of the TMBs
+    captureFile = cms.untracked.string(""),
+
+    # chambers (e.g. "ME+1/2/13") whose board decisions are recorded into
+    # traceFile, to be decoded with CSCTriggerTraceDump
+    traceChambers = cms.untracked.vstring(),
+    traceFile = cms.untracked.string("csctrace.bin"),
+
+    # if set, only the chambers in this std::vector<DetId> (CSC ids of any
+    # layer, ME1/a standing for ME1/1) are run, and their neighbours in the
+    # same ring if roiNeighbours is True
+    roiChambers = cms.untracked.InputTag(""),
+    roiNeighbours = cms.untracked.bool(False),
+
+    # output collections; those switched off are neither filled nor put in
+    # the event, and the MPC is not run if MPCSORTED is not produced
+    produceALCTs = cms.untracked.bool(True),
+    produceCLCTs = cms.untracked.bool(True),
+    producePreTriggers = cms.untracked.bool(True),
+    produceLCTs = cms.untracked.bool(True),
+    produceMPCLCTs = cms.untracked.bool(True),
+
     # Parameters common for all boards
     commonParam = cms.PSet(
         isTMB07 = cms.bool(True),
@@ -94,6 +125,9 @@ cscTriggerPrimitiveDigis = cms.EDProducer("CSCTriggerPrimitivesProducer",
         # Use narrow pattern mask for ring 1 chambers
         alctNarrowMaskForR1 = cms.untracked.bool(False),
 
+        # find ALCT pretriggers and patterns for all key wires at once
+        alctBitParallelPatterns = cms.untracked.bool(False),
+
         # configured, not hardcoded, hit persistency
         alctHitPersist  = cms.untracked.uint32(6)
     ),
@@ -118,6 +152,9 @@ cscTriggerPrimitiveDigis = cms.EDProducer("CSCTriggerPrimitivesProducer",
         # Use narrow pattern mask for ring 1 chambers
         alctNarrowMaskForR1 = cms.untracked.bool(True),
 
+        # find ALCT pretriggers and patterns for all key wires at once
+        alctBitParallelPatterns = cms.untracked.bool(False),
+
         # configured, not hardcoded, hit persistency
         alctHitPersist  = cms.untracked.uint32(6),
 
@@ -182,7 +219,10 @@ cscTriggerPrimitiveDigis = cms.EDProducer("CSCTriggerPrimitivesProducer",
         verbosity = cms.untracked.int32(0),
 
         # BX to start CLCT finding (poor man's dead-time shortening):
-        clctStartBxShift  = cms.untracked.int32(0)
+        clctStartBxShift  = cms.untracked.int32(0),
+
+        # count pattern layers for all key half-strips at once
+        clctBitParallelPatterns = cms.untracked.bool(False)
     ),
 
     # Parameters for CLCT processors: SLHC studies
@@ -202,6 +242,9 @@ cscTriggerPrimitiveDigis = cms.EDProducer("CSCTriggerPrimitivesProducer",
 
         # BX to start CLCT finding (poor man's to shorten the dead-time):
         clctStartBxShift  = cms.untracked.int32(0),
+
+        # count pattern layers for all key half-strips at once
+        clctBitParallelPatterns = cms.untracked.bool(False),
         
         # Turns on algorithms of localized dead-time zones:
         useDeadTimeZoning = cms.untracked.bool(True),
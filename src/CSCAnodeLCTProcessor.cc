@@ -27,12 +27,18 @@
 //-----------------------------------------------------------------------------
 
 #include <L1Trigger/CSCTriggerPrimitives/src/CSCAnodeLCTProcessor.h>
-#include <L1Trigger/CSCCommonTrigger/interface/CSCTriggerGeometry.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCMedianBx.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesStats.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerTrace.h>
 #include <DataFormats/MuonDetId/interface/CSCTriggerNumbering.h>
 
 #include <FWCore/MessageLogger/interface/MessageLogger.h>
 
-#include <set>
+#include "tbb/enumerable_thread_specific.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 
 //-----------------
 // Static variables
@@ -189,8 +195,6 @@ CSCAnodeLCTProcessor::CSCAnodeLCTProcessor(unsigned endcap, unsigned station,
                                            const edm::ParameterSet& comm) : 
                      theEndcap(endcap), theStation(station), theSector(sector),
                      theSubsector(subsector), theTrigChamber(chamber) {
-  static bool config_dumped = false;
-
   // ALCT configuration parameters.
   fifo_tbins   = conf.getParameter<unsigned int>("alctFifoTbins");
   fifo_pretrig = conf.getParameter<unsigned int>("alctFifoPretrig");
@@ -241,12 +245,16 @@ CSCAnodeLCTProcessor::CSCAnodeLCTProcessor(unsigned endcap, unsigned station,
   // whether to use narrow pattern mask for the rings close to the beam
   narrow_mask_r1 = conf.getUntrackedParameter<bool>("alctNarrowMaskForR1", false);
 
+  // whether to use the bit-parallel pretrigger and pattern engine
+  use_bit_parallel = conf.getUntrackedParameter<bool>("alctBitParallelPatterns", false);
+
   // Check and print configuration parameters.
   checkConfigParameters();
-  if ((infoV > 0 || isSLHC) && !config_dumped) {
+  // Dumped once per process, by whichever board gets here first.
+  static std::atomic<bool> config_dumped(false);
+  if ((infoV > 0 || isSLHC) && !config_dumped.exchange(true)) {
     //std::cout<<"**** ALCT constructor parameters dump ****"<<std::endl;
     dumpConfigParams();
-    config_dumped = true;
   }
 
   numWireGroups = 0;  // Will be set later.
@@ -276,16 +284,22 @@ CSCAnodeLCTProcessor::CSCAnodeLCTProcessor(unsigned endcap, unsigned station,
 
   //if (theStation==1 && theRing==2) infoV = 3;
 
+  trace = 0;
+  traceId = 0;
+
   // Load appropriate pattern mask.
   loadPatternMask();
+
+  // Pick the algorithm variant for this configuration.
+  selectAlgorithm();
+
+  attachScratch();
 }
 
 CSCAnodeLCTProcessor::CSCAnodeLCTProcessor() :
                        theEndcap(1), theStation(1), theSector(1),
                      theSubsector(1), theTrigChamber(1) {
   // Used for debugging. -JM
-  static bool config_dumped = false;
-
   // ALCT parameters.
   setDefaultConfigParameters();
   infoV = 2;
@@ -297,12 +311,16 @@ CSCAnodeLCTProcessor::CSCAnodeLCTProcessor() :
 
   early_tbins = 4;
 
+  use_bit_parallel = false;
+  use_corrected_bx = false;
+  narrow_mask_r1 = false;
+
   // Check and print configuration parameters.
   checkConfigParameters();
-  if (!config_dumped) {
+  static std::atomic<bool> config_dumped(false);
+  if (!config_dumped.exchange(true)) {
     //std::cout<<"**** ALCT default constructor parameters dump ****"<<std::endl;
     dumpConfigParams();
-    config_dumped = true;
   }
 
   numWireGroups = CSCConstants::MAX_NUM_WIRES;
@@ -313,25 +331,108 @@ CSCAnodeLCTProcessor::CSCAnodeLCTProcessor() :
                                                              theStation, theTrigChamber);
   isME11 = (theStation == 1 && theRing == 1);
 
+  trace = 0;
+  traceId = 0;
+
   // Load pattern mask.
   loadPatternMask();
+
+  selectAlgorithm();
+
+  attachScratch();
+}
+
+void CSCAnodeLCTProcessor::setTrace(CSCTriggerTrace* t) {
+  trace = t;
+  traceId = CSCDetId(theEndcap, theStation, theRing, theChamber, 0).rawId();
+}
+
+CSCAnodeLCTProcessor::Scratch& CSCAnodeLCTProcessor::threadScratch() {
+  // The arena of a thread is created the first time an ALCT processor is
+  // run on it.  A thread runs one chamber at a time, so the processors
+  // sharing an arena never use it concurrently.
+  static tbb::enumerable_thread_specific<Scratch> arenas;
+  return arenas.local();
+}
+
+void CSCAnodeLCTProcessor::attachScratch() {
+  Scratch& scratch   = threadScratch();
+  first_bx           = scratch.first_bx;
+  first_bx_corrected = scratch.first_bx_corrected;
+  quality            = scratch.quality;
+  digiV              = scratch.digiV;
+  pulse              = scratch.pulse;
+  wire_times         = scratch.wire_times;
+  pattern_layers     = scratch.pattern_layers;
+  pretrig_keys       = scratch.pretrig_keys;
+  scratch.owner      = this;
+}
+
+void CSCAnodeLCTProcessor::selectAlgorithm() {
+  // The flags below are fixed for the lifetime of the processor, so the
+  // pattern detection variant is chosen here once rather than being
+  // re-checked for every pattern of every key wire.
+  if (use_bit_parallel) {
+    if (isTMB07) pattern_detection = &CSCAnodeLCTProcessor::patternDetectionKernel<true, true>;
+    else         pattern_detection = &CSCAnodeLCTProcessor::patternDetectionKernel<true, false>;
+  }
+  else {
+    if (isTMB07) pattern_detection = &CSCAnodeLCTProcessor::patternDetectionKernel<false, true>;
+    else         pattern_detection = &CSCAnodeLCTProcessor::patternDetectionKernel<false, false>;
+  }
 }
 
 
 void CSCAnodeLCTProcessor::loadPatternMask() {
   // Load appropriate pattern mask.
-  for (int i_patt = 0; i_patt < CSCConstants::NUM_ALCT_PATTERNS; i_patt++) {
-    for (int i_wire = 0; i_wire < NUM_PATTERN_WIRES; i_wire++) {
-      if (isMTCC || isTMB07) {
-        pattern_mask[i_patt][i_wire] = pattern_mask_open[i_patt][i_wire];
-        if (narrow_mask_r1 && (theRing == 1 || theRing == 4))
-          pattern_mask[i_patt][i_wire] = pattern_mask_r1[i_patt][i_wire];
-      }
-      else {
-        pattern_mask[i_patt][i_wire] = pattern_mask_slim[i_patt][i_wire];
+  int mask_type = MASK_SLIM;
+  if (isMTCC || isTMB07) {
+    mask_type = MASK_OPEN;
+    if (narrow_mask_r1 && (theRing == 1 || theRing == 4))
+      mask_type = MASK_R1;
+  }
+  pattern_cells = &patternCells(mask_type, MESelection);
+}
+
+const CSCAnodeLCTProcessor::PatternCells&
+CSCAnodeLCTProcessor::patternCells(const int mask_type,
+                                   const int me_selection) {
+  // Built on first use (the initialization of a local static is
+  // thread-safe); read-only afterwards.  The cells are derived from the
+  // public mask arrays, which are plain static const members defined in
+  // this file and so cannot be read at compile time; writing the cells
+  // out by hand would duplicate the masks.
+  static const std::vector<PatternCells> all_cells = buildPatternCells();
+  return all_cells[2*mask_type + me_selection];
+}
+
+std::vector<CSCAnodeLCTProcessor::PatternCells>
+CSCAnodeLCTProcessor::buildPatternCells() {
+  // Keep the cells of the envelope which are in the mask, layer by layer;
+  // the envelope is ordered by layer, so is the order of the cells.
+  const int (*masks[NUM_PATTERN_MASKS])[NUM_PATTERN_WIRES] = {
+    pattern_mask_slim, pattern_mask_open, pattern_mask_r1
+  };
+  std::vector<PatternCells> all_cells(2*NUM_PATTERN_MASKS);
+  for (int mask_type = 0; mask_type < NUM_PATTERN_MASKS; mask_type++) {
+    for (int me_selection = 0; me_selection < 2; me_selection++) {
+      PatternCells& cells = all_cells[2*mask_type + me_selection];
+      for (int i_patt = 0; i_patt < CSCConstants::NUM_ALCT_PATTERNS; i_patt++) {
+        int n_cells = 0;
+        for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+          cells.layer_begin[i_patt][i_layer] = n_cells;
+          for (int i_wire = 0; i_wire < NUM_PATTERN_WIRES; i_wire++) {
+            if (masks[mask_type][i_patt][i_wire] == 0 ||
+                pattern_envelope[0][i_wire] != i_layer) continue;
+            cells.delta_wire[i_patt][n_cells++] =
+              pattern_envelope[1+me_selection][i_wire];
+          }
+        }
+        cells.layer_begin[i_patt][CSCConstants::NUM_LAYERS] = n_cells;
       }
     }
   }
+  return all_cells;
 }
 
 
@@ -351,7 +452,6 @@ void CSCAnodeLCTProcessor::setDefaultConfigParameters() {
 
 // Set configuration parameters obtained via EventSetup mechanism.
 void CSCAnodeLCTProcessor::setConfigParameters(const CSCDBL1TPParameters* conf) {
-  static bool config_dumped = false;
 
   fifo_tbins   = conf->alctFifoTbins();
   fifo_pretrig = conf->alctFifoPretrig();
@@ -366,10 +466,10 @@ void CSCAnodeLCTProcessor::setConfigParameters(const CSCDBL1TPParameters* conf)
 
   // Check and print configuration parameters.
   checkConfigParameters();
-  if (!config_dumped) {
+  static std::atomic<bool> config_dumped(false);
+  if (!config_dumped.exchange(true)) {
     //std::cout<<"**** ALCT setConfigParam parameters dump ****"<<std::endl;
     dumpConfigParams();
-    config_dumped = true;
   }
 }
 
@@ -473,6 +573,28 @@ void CSCAnodeLCTProcessor::checkConfigParameters() {
   }
 }
 
+void CSCAnodeLCTProcessor::setChamberGeometry(const CSCChamberGeometryInfo& info) {
+  if (info.exists) {
+    numWireGroups = info.numWireGroups;
+    if (numWireGroups > CSCConstants::MAX_NUM_WIRES) {
+      if (infoV >= 0) edm::LogError("L1CSCTPEmulatorSetupError")
+        << "+++ Number of wire groups, " << numWireGroups
+        << " found in " << theMEStr << " " << theTrigStr
+        << " exceeds max expected, " << CSCConstants::MAX_NUM_WIRES
+        << " +++\n" 
+        << "+++ CSC geometry looks garbled; no emulation possible +++\n";
+      numWireGroups = -1;
+    }
+  }
+  else {
+    if (infoV >= 0) edm::LogError("L1CSCTPEmulatorSetupError")
+      << "+++ " << theMEStr << " " << theTrigStr
+      << " is not defined in current geometry! +++\n"
+      << "+++ CSC geometry looks garbled; no emulation possible +++\n";
+    numWireGroups = -1;
+  }
+}
+
 void CSCAnodeLCTProcessor::clear() {
   for (int bx = 0; bx < MAX_ALCT_BINS; bx++) {
     bestALCT[bx].clear();
@@ -496,42 +618,18 @@ CSCAnodeLCTProcessor::run(const CSCWireDigiCollection* wiredc) {
 
   // clear(); // redundant; called by L1MuCSCMotherboard.
 
-  static bool config_dumped = false;
-  if ((infoV > 0 || isSLHC) && !config_dumped) {
+  attachScratch();
+
+  static std::atomic<bool> config_dumped(false);
+  if ((infoV > 0 || isSLHC) && !config_dumped.exchange(true)) {
     //std::cout<<"**** ALCT run parameters dump ****"<<std::endl;
     dumpConfigParams();
-    config_dumped = true;
-  }
-
-
-  // Get the number of wire groups for the given chamber.  Do it only once
-  // per chamber.
-  if (numWireGroups == 0) {
-    CSCTriggerGeomManager* theGeom = CSCTriggerGeometry::get();
-    CSCChamber* chamber = theGeom->chamber(theEndcap, theStation, theSector,
-                                           theSubsector, theTrigChamber);
-    if (chamber) {
-      numWireGroups = chamber->layer(1)->geometry()->numberOfWireGroups();
-      if (numWireGroups > CSCConstants::MAX_NUM_WIRES) {
-        if (infoV >= 0) edm::LogError("L1CSCTPEmulatorSetupError")
-          << "+++ Number of wire groups, " << numWireGroups
-          << " found in " << theMEStr << " " << theTrigStr
-          << " exceeds max expected, " << CSCConstants::MAX_NUM_WIRES
-          << " +++\n" 
-          << "+++ CSC geometry looks garbled; no emulation possible +++\n";
-        numWireGroups = -1;
-      }
-    }
-    else {
-      if (infoV >= 0) edm::LogError("L1CSCTPEmulatorSetupError")
-        << "+++ " << theMEStr << " " << theTrigStr
-        << " is not defined in current geometry! +++\n"
-        << "+++ CSC geometry looks garbled; no emulation possible +++\n";
-      numWireGroups = -1;
-    }
   }
 
-  if (numWireGroups < 0) {
+
+  // The number of wire groups comes from the geometry snapshot handed over
+  // by the builder; it is still 0 if there was none.
+  if (numWireGroups <= 0) {
     if (infoV >= 0) edm::LogError("L1CSCTPEmulatorSetupError")
       << "+++ " << theMEStr << " " << theTrigStr
       << ": numWireGroups = " << numWireGroups
@@ -544,10 +642,19 @@ CSCAnodeLCTProcessor::run(const CSCWireDigiCollection* wiredc) {
   bool noDigis = getDigis(wiredc);
 
   if (!noDigis) {
-    // First get wire times from the wire digis.
-    std::vector<int>
-      wire[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES];
-    readWireDigis(wire);
+    // First get wire times from the wire digis.  The arrays of times are
+    // kept in the scratch arena so that no memory is allocated once their
+    // capacity has grown.
+    std::vector<int> (*wire)[CSCConstants::MAX_NUM_WIRES] = wire_times;
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+      for (int i_wire = 0; i_wire < CSCConstants::MAX_NUM_WIRES; i_wire++) {
+        wire[i_layer][i_wire].clear();
+      }
+    }
+    {
+      CSCTP_TIME(theStation, theRing, READ_WIRE_DIGIS);
+      readWireDigis(wire);
+    }
 
     // Pass an array of wire times on to another run() doing the LCT search.
     // If the number of layers containing digis is smaller than that
@@ -580,10 +687,17 @@ void CSCAnodeLCTProcessor::run(const std::vector<int> wire[CSCConstants::NUM_LAY
   // It gets wire times from an input array and then loops over the keywires.
   // All found LCT candidates are sorted and the best two are retained.
 
+  attachScratch();
+
   bool trigger = false;
 
   // Check if there are any in-time hits and do the pulse extension.
-  bool chamber_empty = pulseExtension(wire);
+  bool chamber_empty;
+  {
+    CSCTP_TIME(theStation, theRing, PULSE_EXTENSION);
+    chamber_empty = pulseExtension(wire);
+    if (!chamber_empty && use_bit_parallel) fillPatternBits();
+  }
 
   // Only do the rest of the processing if chamber is not empty.
   // Stop drift_delay bx's short of fifo_tbins since at later bx's we will
@@ -594,9 +708,31 @@ void CSCAnodeLCTProcessor::run(const std::vector<int> wire[CSCConstants::NUM_LAY
       unsigned int start_bx = 0;
       // Allow for more than one pass over the hits in the time window.
       while (start_bx < stop_bx) {
-        if (preTrigger(i_wire, start_bx)) {
+        bool pre_trig;
+        {
+          CSCTP_TIME(theStation, theRing, PRE_TRIGGER);
+          pre_trig = preTrigger(i_wire, start_bx);
+        }
+        if (pre_trig) {
+          CSCTP_COUNT(theStation, theRing, PRETRIGGERS, 1);
+          if (trace) trace->record(traceId, CSCTriggerTrace::ALCT,
+                                   CSCTriggerTrace::PRETRIGGER,
+                                   first_bx[i_wire], i_wire, 0, 0);
           if (infoV > 2) showPatterns(i_wire);
-          if (patternDetection(i_wire)) {
+          bool found;
+          {
+            CSCTP_TIME(theStation, theRing, PATTERN_DETECTION);
+            CSCTP_COUNT(theStation, theRing, PATTERN_SEARCHES, 1);
+            found = patternDetection(i_wire);
+          }
+          if (found) {
+            if (trace) {
+              for (int i_pattern = 0; i_pattern < 2; i_pattern++)
+                if (quality[i_wire][i_pattern] > 0)
+                  trace->record(traceId, CSCTriggerTrace::ALCT,
+                                CSCTriggerTrace::PATTERN_HIT, first_bx[i_wire],
+                                i_wire, i_pattern, quality[i_wire][i_pattern]);
+            }
             trigger = true;
             break;
           }
@@ -605,6 +741,8 @@ void CSCAnodeLCTProcessor::run(const std::vector<int> wire[CSCConstants::NUM_LAY
             // occur in case pattern detection failed is bx_pretrigger+4:
             // this seems to match the data.
             start_bx = first_bx[i_wire] + drift_delay + pretrig_extra_deadtime;
+            CSCTP_COUNT(theStation, theRing, DEAD_TIME_BX,
+                        drift_delay + pretrig_extra_deadtime);
           }
         }
         else {
@@ -616,15 +754,25 @@ void CSCAnodeLCTProcessor::run(const std::vector<int> wire[CSCConstants::NUM_LAY
 
   // Do the rest only if there is at least one trigger candidate.
   if (trigger) {
-    if (isSLHC) ghostCancellationLogicSLHC();
-    else ghostCancellationLogic();
+    {
+      CSCTP_TIME(theStation, theRing, GHOST_CANCELLATION);
+      if (isSLHC) ghostCancellationLogicSLHC();
+      else ghostCancellationLogic();
+    }
+    CSCTP_TIME(theStation, theRing, LCT_SEARCH);
     lctSearch();
   }
+
+  // The working arrays must not have been taken over by another processor
+  // while this one ran, as they would be if this thread ran a stolen task
+  // of another chamber in the middle of this one.
+  assert(threadScratch().owner == this);
 }
 
 bool CSCAnodeLCTProcessor::getDigis(const CSCWireDigiCollection* wiredc) {
   // Routine for getting digis and filling digiV vector.
   bool noDigis = true;
+  attachScratch();
 
   // Loop over layers and save wire digis on each one into digiV[layer].
   for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
@@ -665,6 +813,20 @@ void CSCAnodeLCTProcessor::getDigis(const CSCWireDigiCollection* wiredc,
   }
 }
 
+void CSCAnodeLCTProcessor::readWireDigis(const std::vector<CSCWireDigi> digis[CSCConstants::NUM_LAYERS],
+                                         std::vector<int> wire[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES]) {
+  // Standalone version of getDigis() and readWireDigis(wire): the digis
+  // are given per layer instead of being looked up in a collection.
+  attachScratch();
+  for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+    digiV[i_layer].assign(digis[i_layer].begin(), digis[i_layer].end());
+    for (int i_wire = 0; i_wire < CSCConstants::MAX_NUM_WIRES; i_wire++) {
+      wire[i_layer][i_wire].clear();
+    }
+  }
+  readWireDigis(wire);
+}
+
 void CSCAnodeLCTProcessor::readWireDigis(std::vector<int> wire[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES]) {
   /* Gets wire times from the wire digis and fills wire[][] vector */
 
@@ -674,8 +836,15 @@ void CSCAnodeLCTProcessor::readWireDigis(std::vector<int> wire[CSCConstants::NUM
     // time for each.
     for (std::vector<CSCWireDigi>::iterator pld = digiV[i_layer].begin();
          pld != digiV[i_layer].end(); pld++) {
+      CSCTP_COUNT(theStation, theRing, DIGIS, 1);
       int i_wire  = pld->getWireGroup()-1;
-      std::vector<int> bx_times = pld->getTimeBinsOn();
+      // Time bins on, decoded from the time-bin word of the digi.
+      const unsigned int tbin_word = pld->getTimeBinWord();
+      int bx_times[8*sizeof(tbin_word)];
+      unsigned int n_bins = 0;
+      for (unsigned int tbin = 0; tbin < 8*sizeof(tbin_word); tbin++) {
+        if ((tbin_word >> tbin) & 1) bx_times[n_bins++] = tbin;
+      }
 
       // Check that the wires and times are appropriate.
       if (i_wire < 0 || i_wire >= numWireGroups) {
@@ -692,12 +861,12 @@ void CSCAnodeLCTProcessor::readWireDigis(std::vector<int> wire[CSCConstants::NUM
       // use them since they can modify the ALCTs found later, via
       // ghost-cancellation logic.
       int last_time = -999;
-      if (bx_times.size() == fifo_tbins) {
+      if (n_bins == fifo_tbins) {
         wire[i_layer][i_wire].push_back(0);        
         wire[i_layer][i_wire].push_back(6);
       }
       else {
-        for (unsigned int i = 0; i < bx_times.size(); i++) {
+        for (unsigned int i = 0; i < n_bins; i++) {
           // Find rising edge change
           if (i > 0 && bx_times[i] == (bx_times[i-1]+1)) continue;
           if (bx_times[i] < static_cast<int>(fifo_tbins)) {
@@ -733,7 +902,7 @@ bool CSCAnodeLCTProcessor::pulseExtension(const std::vector<int> wire[CSCConstan
 
   bool chamber_empty = true;
   int i_wire, i_layer, digi_num;
-  static unsigned int bits_in_pulse = 8*sizeof(pulse[0][0]);
+  const unsigned int bits_in_pulse = 8*sizeof(pulse[0][0]);
 
   for (i_wire = 0; i_wire < numWireGroups; i_wire++) {
     for (i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
@@ -748,7 +917,7 @@ bool CSCAnodeLCTProcessor::pulseExtension(const std::vector<int> wire[CSCConstan
     digi_num = 0;
     for (i_wire = 0; i_wire < numWireGroups; i_wire++) {
       if (wire[i_layer][i_wire].size() > 0) {
-        std::vector<int> bx_times = wire[i_layer][i_wire];
+        const std::vector<int>& bx_times = wire[i_layer][i_wire];
         for (unsigned int i = 0; i < bx_times.size(); i++) {
           // Check that min and max times are within the allowed range.
           if (bx_times[i] < 0 || bx_times[i] + hit_persist >= bits_in_pulse) {
@@ -764,6 +933,7 @@ bool CSCAnodeLCTProcessor::pulseExtension(const std::vector<int> wire[CSCConstan
           if (chamber_empty) chamber_empty = false;
 
           // make the pulse
+          CSCTP_COUNT(theStation, theRing, PULSES, 1);
           for (unsigned int bx = bx_times[i];
                bx < (bx_times[i] + hit_persist); bx++)
           pulse[i_layer][i_wire] = pulse[i_layer][i_wire] | (1 << bx);
@@ -799,9 +969,31 @@ bool CSCAnodeLCTProcessor::preTrigger(const int key_wire, const int start_bx) {
      or accelerator patterns for a particular key_wire.  If so, return
      true and the PatternDetection process will start. */
 
+  // Stop drift_delay bx's short of fifo_tbins since at later bx's we will
+  // not have a full set of hits to start pattern search anyway.
+  unsigned int stop_bx = fifo_tbins - drift_delay;
+
+  if (use_bit_parallel) {
+    // Pretriggers of all key wires were found in fillPatternBits().
+    for (unsigned int bx_time = start_bx; bx_time < stop_bx; bx_time++) {
+      for (int i_pattern = 0; i_pattern < CSCConstants::NUM_ALCT_PATTERNS; i_pattern++) {
+        if (pretrig_keys[i_pattern][bx_time].test(key_wire)) {
+          first_bx[key_wire] = bx_time;
+          if (infoV > 1) {
+            LogTrace("CSCAnodeLCTProcessor")
+              << "Pretrigger was satisfied for wire: " << key_wire
+              << " pattern: " << i_pattern
+              << " bx_time: " << bx_time;
+          }
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
   unsigned int layers_hit;
-  bool hit_layer[CSCConstants::NUM_LAYERS];
-  int this_layer, this_wire;
+  int this_wire;
   // If nplanes_hit_accel_pretrig is 0, the firmware uses the value
   // of nplanes_hit_pretrig instead.
   const unsigned int nplanes_hit_pretrig_acc =
@@ -813,43 +1005,37 @@ bool CSCAnodeLCTProcessor::preTrigger(const int key_wire, const int start_bx) {
 
   // Loop over bx times, accelerator and collision patterns to 
   // look for pretrigger.
-  // Stop drift_delay bx's short of fifo_tbins since at later bx's we will
-  // not have a full set of hits to start pattern search anyway.
-  unsigned int stop_bx = fifo_tbins - drift_delay;
   for (unsigned int bx_time = start_bx; bx_time < stop_bx; bx_time++) {
     for (int i_pattern = 0; i_pattern < CSCConstants::NUM_ALCT_PATTERNS; i_pattern++) {
-      for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
-        hit_layer[i_layer] = false;
+      const int* layer_begin = pattern_cells->layer_begin[i_pattern];
+      const int* delta_wire  = pattern_cells->delta_wire[i_pattern];
       layers_hit = 0;
 
-      for (int i_wire = 0; i_wire < NUM_PATTERN_WIRES; i_wire++){
-        if (pattern_mask[i_pattern][i_wire] != 0){
-          this_layer = pattern_envelope[0][i_wire];
-          this_wire  = pattern_envelope[1+MESelection][i_wire]+key_wire;
+      for (int this_layer = 0; this_layer < CSCConstants::NUM_LAYERS; this_layer++){
+        for (int i_cell = layer_begin[this_layer]; i_cell < layer_begin[this_layer+1]; i_cell++){
+          this_wire = delta_wire[i_cell]+key_wire;
           if ((this_wire >= 0) && (this_wire < numWireGroups)){
             // Perform bit operation to see if pulse is 1 at a certain bx_time.
             if (((pulse[this_layer][this_wire] >> bx_time) & 1) == 1) {
               // Store number of layers hit.
-              if (hit_layer[this_layer] == false){
-                hit_layer[this_layer] = true;
-                layers_hit++;
-              }
-
-              // See if number of layers hit is greater than or equal to
-              // pretrig_thresh.
-              if (layers_hit >= pretrig_thresh[i_pattern]) {
-                first_bx[key_wire] = bx_time;
-                if (infoV > 1) {
-                  LogTrace("CSCAnodeLCTProcessor")
-                    << "Pretrigger was satisfied for wire: " << key_wire
-                    << " pattern: " << i_pattern
-                    << " bx_time: " << bx_time;
-                }
-                return true;
-              }
+              layers_hit++;
+              break;
             }
           }
         }
+
+        // See if number of layers hit is greater than or equal to
+        // pretrig_thresh.
+        if (layers_hit >= pretrig_thresh[i_pattern] && layers_hit > 0) {
+          first_bx[key_wire] = bx_time;
+          if (infoV > 1) {
+            LogTrace("CSCAnodeLCTProcessor")
+              << "Pretrigger was satisfied for wire: " << key_wire
+              << " pattern: " << i_pattern
+              << " bx_time: " << bx_time;
+          }
+          return true;
+        }
       }
     }
   }
@@ -858,14 +1044,20 @@ bool CSCAnodeLCTProcessor::preTrigger(const int key_wire, const int start_bx) {
 }
 
 bool CSCAnodeLCTProcessor::patternDetection(const int key_wire) {
+  return (this->*pattern_detection)(key_wire);
+}
+
+template <bool BitParallel, bool TMB07>
+bool CSCAnodeLCTProcessor::patternDetectionKernel(const int key_wire) {
   /* See if there is a pattern that satisfies nplanes_hit_pattern number of
      layers hit for either the accelerator or collision patterns.  Use
-     the pattern with the best quality. */
+     the pattern with the best quality.  BitParallel and TMB07 stand for
+     use_bit_parallel and isTMB07, see selectAlgorithm(). */
 
   bool trigger = false;
-  bool hit_layer[CSCConstants::NUM_LAYERS];
+  bool hit_layer;
   unsigned int temp_quality;
-  int this_layer, this_wire, delta_wire;
+  int this_wire, delta_wire;
   // If nplanes_hit_accel_pattern is 0, the firmware uses the value
   // of nplanes_hit_pattern instead.
   const unsigned int nplanes_hit_pattern_acc =
@@ -874,60 +1066,77 @@ bool CSCAnodeLCTProcessor::patternDetection(const int key_wire) {
   const unsigned int pattern_thresh[CSCConstants::NUM_ALCT_PATTERNS] = {
     nplanes_hit_pattern_acc, nplanes_hit_pattern, nplanes_hit_pattern
   };
-  const std::string ptn_label[] = {"Accelerator", "CollisionA", "CollisionB"};
+  static const char* const ptn_label[] = {"Accelerator", "CollisionA", "CollisionB"};
 
   for (int i_pattern = 0; i_pattern < CSCConstants::NUM_ALCT_PATTERNS; i_pattern++){
     temp_quality = 0;
-    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
-      hit_layer[i_layer] = false;
+    const int* layer_begin = pattern_cells->layer_begin[i_pattern];
+    const int* pattern_delta_wire = pattern_cells->delta_wire[i_pattern];
 
     double num_pattern_hits=0., times_sum=0.;
-    std::multiset<int> mset_for_median;
-    mset_for_median.clear();
-
-    for (int i_wire = 0; i_wire < NUM_PATTERN_WIRES; i_wire++){
-      if (pattern_mask[i_pattern][i_wire] != 0){
-        this_layer = pattern_envelope[0][i_wire];
-        delta_wire = pattern_envelope[1+MESelection][i_wire];
-        this_wire  = delta_wire + key_wire;
-        if ((this_wire >= 0) && (this_wire < numWireGroups)){
-
-          // Wait a drift_delay time later and look for layers hit in
-          // the pattern.
-          if ( ( (pulse[this_layer][this_wire] >> 
-                 (first_bx[key_wire] + drift_delay)) & 1) == 1) {
-
-            // If layer has never had a hit before, then increment number
-            // of layer hits.
-            if (hit_layer[this_layer] == false){
-              temp_quality++;
-              // keep track of which layers already had hits.
-              hit_layer[this_layer] = true;
-              if (infoV > 1)
-                LogTrace("CSCAnodeLCTProcessor")
-                  << "bx_time: " << first_bx[key_wire]
-                  << " pattern: " << i_pattern << " keywire: " << key_wire
-                  << " layer: "     << this_layer
-                  << " quality: "   << temp_quality;
-            }
+    int times_for_median[NUM_PATTERN_WIRES];
+    int n_times = 0;
+
+    if (BitParallel) {
+      // The number of layers hit is known from fillPatternBits(); only the
+      // hits near the key wire are looked at, for the averaged time.
+      temp_quality =
+        patternLayers(key_wire, i_pattern, first_bx[key_wire] + drift_delay);
+      for (int this_layer = 0; this_layer < CSCConstants::NUM_LAYERS; this_layer++){
+        for (int i_cell = layer_begin[this_layer]; i_cell < layer_begin[this_layer+1]; i_cell++){
+          delta_wire = pattern_delta_wire[i_cell];
+          if (abs(delta_wire) >= 2) continue;
+          this_wire  = delta_wire + key_wire;
+          if ((this_wire >= 0) && (this_wire < numWireGroups) &&
+              ((pulse[this_layer][this_wire] >>
+                (first_bx[key_wire] + drift_delay)) & 1) == 1) {
+            times_for_median[n_times++] =
+              pulseStartBx(this_layer, this_wire, first_bx[key_wire] + drift_delay);
+          }
+        }
+      }
+    }
+    else {
+      for (int this_layer = 0; this_layer < CSCConstants::NUM_LAYERS; this_layer++){
+        hit_layer = false;
+        for (int i_cell = layer_begin[this_layer]; i_cell < layer_begin[this_layer+1]; i_cell++){
+          delta_wire = pattern_delta_wire[i_cell];
+          this_wire  = delta_wire + key_wire;
+          if ((this_wire >= 0) && (this_wire < numWireGroups)){
+
+            // Wait a drift_delay time later and look for layers hit in
+            // the pattern.
+            if ( ( (pulse[this_layer][this_wire] >> 
+                   (first_bx[key_wire] + drift_delay)) & 1) == 1) {
+
+              // If layer has never had a hit before, then increment number
+              // of layer hits.
+              if (hit_layer == false){
+                temp_quality++;
+                // keep track of which layers already had hits.
+                hit_layer = true;
+                if (infoV > 1)
+                  LogTrace("CSCAnodeLCTProcessor")
+                    << "bx_time: " << first_bx[key_wire]
+                    << " pattern: " << i_pattern << " keywire: " << key_wire
+                    << " layer: "     << this_layer
+                    << " quality: "   << temp_quality;
+              }
             
-            // for averaged time use only the closest WGs around the key WG
-            if (abs(delta_wire)<2) {
-              // find at what bx did pulse on this wire&layer start
-              // use hit_pesrist constraint on how far back we can go
-              int first_bx_layer = first_bx[key_wire] + drift_delay;
-              for (unsigned int dbx=0; dbx<hit_persist; dbx++) {
-                if (((pulse[this_layer][this_wire] >> (first_bx_layer-1)) & 1) == 1) first_bx_layer--;
-                else break;
+              // for averaged time use only the closest WGs around the key WG
+              if (abs(delta_wire)<2) {
+                // find at what bx did pulse on this wire&layer start
+                int first_bx_layer =
+                  pulseStartBx(this_layer, this_wire, first_bx[key_wire] + drift_delay);
+                times_sum += (double)first_bx_layer;
+                num_pattern_hits += 1.;
+                times_for_median[n_times++] = first_bx_layer;
+                if (infoV > 2) 
+                  LogTrace("CSCAnodeLCTProcessor")
+                    <<" 1st bx in layer: "<<first_bx_layer
+                    <<" sum bx: "<<times_sum
+                    <<" #pat. hits: "<<num_pattern_hits;
               }
-              times_sum += (double)first_bx_layer;
-              num_pattern_hits += 1.;
-              mset_for_median.insert(first_bx_layer);
-              if (infoV > 2) 
-                LogTrace("CSCAnodeLCTProcessor")
-                  <<" 1st bx in layer: "<<first_bx_layer
-                  <<" sum bx: "<<times_sum
-                  <<" #pat. hits: "<<num_pattern_hits;
             }
           }
         }
@@ -935,27 +1144,22 @@ bool CSCAnodeLCTProcessor::patternDetection(const int key_wire) {
     }
 
     // calculate median
-    const int sz = mset_for_median.size();
-    if (sz > 0) {
-      std::multiset<int>::iterator im = mset_for_median.begin();
-      if (sz > 1) std::advance(im,sz/2-1);
-      if (sz == 1) first_bx_corrected[key_wire] = *im;
-      else if ((sz % 2) == 1) first_bx_corrected[key_wire] = *(++im);
-      else first_bx_corrected[key_wire] = ((*im) + (*(++im)))/2;
+    if (n_times > 0) {
+      first_bx_corrected[key_wire] = cscMedianBx(times_for_median, n_times);
     
       if (infoV > 1) {
-        char bxs[300]="";
-        for (im = mset_for_median.begin(); im != mset_for_median.end(); im++) 
-          sprintf(bxs,"%s %d", bxs, *im);
+        std::sort(times_for_median, times_for_median + n_times);
+        std::ostringstream bxs;
+        for (int i = 0; i < n_times; i++) bxs << " " << times_for_median[i];
         LogTrace("CSCAnodeLCTProcessor")
-          <<"bx="<<first_bx[key_wire]<<" bx_cor="<< first_bx_corrected[key_wire]<<"  bxset="<<bxs;
+          <<"bx="<<first_bx[key_wire]<<" bx_cor="<< first_bx_corrected[key_wire]<<"  bxset="<<bxs.str();
       }
     }
 
     if (temp_quality >= pattern_thresh[i_pattern]) {
       trigger = true;
 
-      if (!isTMB07) {
+      if (!TMB07) {
         // Quality reported by the pattern detector is defined as the number
         // of the layers hit in a pattern minus (pattern_thresh-1) value.
         temp_quality -= (pattern_thresh[i_pattern]-1);
@@ -997,6 +1201,99 @@ bool CSCAnodeLCTProcessor::patternDetection(const int key_wire) {
   return trigger;
 }
 
+void CSCAnodeLCTProcessor::fillPatternBits() {
+  /* Bit-parallel version of the pretrigger and pattern layer counting.
+     The pulses are transposed into one wire-group bitset per layer and bx.
+     For every pattern and bx, the hits of each pattern cell, shifted by the
+     key-wire offset of the cell, are ORed per layer and the layers are
+     summed into a 3-bit counter kept as three bitsets.  Bit k of the
+     results refers to key wire k.  Gives the same answers as the
+     cell-by-cell loops in preTrigger() and patternDetection(). */
+
+  // If nplanes_hit_accel_pretrig is 0, the firmware uses the value
+  // of nplanes_hit_pretrig instead.
+  const unsigned int nplanes_hit_pretrig_acc =
+    (nplanes_hit_accel_pretrig != 0) ? nplanes_hit_accel_pretrig :
+    nplanes_hit_pretrig;
+  const unsigned int pretrig_thresh[CSCConstants::NUM_ALCT_PATTERNS] = {
+    nplanes_hit_pretrig_acc, nplanes_hit_pretrig, nplanes_hit_pretrig
+  };
+
+  // fifo_tbins is below NUM_PULSE_BX (see checkConfigParameters()).
+  const unsigned int n_bx = fifo_tbins;
+
+  WireBits hits[NUM_PULSE_BX][CSCConstants::NUM_LAYERS];
+  for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+    for (int i_wire = 0; i_wire < numWireGroups; i_wire++) {
+      const unsigned int this_pulse = pulse[i_layer][i_wire];
+      if (this_pulse == 0) continue;
+      for (unsigned int bx = 0; bx < n_bx; bx++) {
+        if ((this_pulse >> bx) & 1) hits[bx][i_layer].set(i_wire);
+      }
+    }
+  }
+
+  WireBits layer_bits, carry;
+  for (int i_pattern = 0; i_pattern < CSCConstants::NUM_ALCT_PATTERNS; i_pattern++) {
+    const int* layer_begin = pattern_cells->layer_begin[i_pattern];
+    const int* delta_wire  = pattern_cells->delta_wire[i_pattern];
+    // The pretrigger needs at least one hit even if the threshold is 0.
+    const unsigned int thresh =
+      (pretrig_thresh[i_pattern] > 0) ? pretrig_thresh[i_pattern] : 1;
+
+    for (unsigned int bx = 0; bx < n_bx; bx++) {
+      WireBits* count = pattern_layers[i_pattern][bx];
+      count[0].reset();
+      count[1].reset();
+      count[2].reset();
+
+      for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+        layer_bits.reset();
+        for (int i_cell = layer_begin[i_layer]; i_cell < layer_begin[i_layer+1]; i_cell++) {
+          if (delta_wire[i_cell] >= 0) layer_bits |= hits[bx][i_layer] >> delta_wire[i_cell];
+          else                         layer_bits |= hits[bx][i_layer] << -delta_wire[i_cell];
+        }
+        // Add one layer to the counter.
+        carry     = count[0] & layer_bits;
+        count[0] ^= layer_bits;
+        layer_bits = count[1] & carry;
+        count[1] ^= carry;
+        count[2] |= layer_bits;
+      }
+
+      // Key wires with at least thresh layers hit.
+      WireBits& keys = pretrig_keys[i_pattern][bx];
+      keys.reset();
+      for (unsigned int n = thresh; n < 8; n++) {
+        keys |= ((n & 1) ? count[0] : ~count[0]) &
+                ((n & 2) ? count[1] : ~count[1]) &
+                ((n & 4) ? count[2] : ~count[2]);
+      }
+    }
+  }
+}
+
+unsigned int CSCAnodeLCTProcessor::patternLayers(const int key_wire,
+                                                 const int i_pattern,
+                                                 const unsigned int bx_time) const {
+  // Number of layers hit in a pattern, as counted by fillPatternBits().
+  const WireBits* count = pattern_layers[i_pattern][bx_time];
+  return (count[0].test(key_wire) ? 1 : 0) + (count[1].test(key_wire) ? 2 : 0) +
+         (count[2].test(key_wire) ? 4 : 0);
+}
+
+int CSCAnodeLCTProcessor::pulseStartBx(const int layer, const int wire,
+                                       const int bx_time) const {
+  // Find at what bx did the pulse on this wire & layer, still on at
+  // bx_time, start; use hit_persist constraint on how far back we can go.
+  int first_bx_layer = bx_time;
+  for (unsigned int dbx=0; dbx<hit_persist; dbx++) {
+    if (((pulse[layer][wire] >> (first_bx_layer-1)) & 1) == 1) first_bx_layer--;
+    else break;
+  }
+  return first_bx_layer;
+}
+
 void CSCAnodeLCTProcessor::ghostCancellationLogic() {
   /* This function looks for LCTs on the previous and next wires.  If one
      exists and it has a better quality and a bx_time up to 4 clocks earlier
@@ -1005,6 +1302,7 @@ void CSCAnodeLCTProcessor::ghostCancellationLogic() {
      previous wire (this has not been done in 2003 test beam).  The
      cancellation is done separately for collision and accelerator patterns. */
 
+  // 1 if cancelled by the previous wire, 2 if by the next one.
   int ghost_cleared[CSCConstants::MAX_NUM_WIRES][2];
 
   for (int key_wire = 0; key_wire < numWireGroups; key_wire++) {
@@ -1056,7 +1354,7 @@ void CSCAnodeLCTProcessor::ghostCancellationLogic() {
           int dt = first_bx[key_wire] - first_bx[key_wire+1];
           // Same cancellation logic as for the previous wire.
           if (dt == 0) {
-            if (qual_next > qual_this) ghost_cleared[key_wire][i_pattern] = 1;
+            if (qual_next > qual_this) ghost_cleared[key_wire][i_pattern] = 2;
           }
           else if (dt > 0 && dt <= ghost_cancellation_bx_depth ) {
             // Next "if" check accounts for firmware bug and should be
@@ -1066,10 +1364,10 @@ void CSCAnodeLCTProcessor::ghostCancellationLogic() {
             ////if (qual_next > qual_this)
             if ((!ghost_cancellation_side_quality) ||
                 (qual_next >= qual_this) )
-              ghost_cleared[key_wire][i_pattern] = 1;
+              ghost_cleared[key_wire][i_pattern] = 2;
           }
         }
-        if (ghost_cleared[key_wire][i_pattern] == 1) {
+        if (ghost_cleared[key_wire][i_pattern] == 2) {
           if (infoV > 1) LogTrace("CSCAnodeLCTProcessor")
             << ((i_pattern == 0) ? "Accelerator" : "Collision")
             << " pattern ghost cancelled on key_wire " << key_wire <<" q="<<qual_this
@@ -1085,6 +1383,12 @@ void CSCAnodeLCTProcessor::ghostCancellationLogic() {
   for (int key_wire = 0; key_wire < numWireGroups; key_wire++) {
     for (int i_pattern = 0; i_pattern < 2; i_pattern++) {
       if (ghost_cleared[key_wire][i_pattern] > 0) {
+        CSCTP_COUNT(theStation, theRing, GHOSTS, 1);
+        if (trace) trace->record(traceId, CSCTriggerTrace::ALCT,
+                                 CSCTriggerTrace::GHOST_CANCEL, first_bx[key_wire],
+                                 key_wire, i_pattern,
+                                 (ghost_cleared[key_wire][i_pattern] == 1) ?
+                                   key_wire-1 : key_wire+1);
         clear(key_wire, i_pattern);
       }
     }
@@ -1101,6 +1405,7 @@ void CSCAnodeLCTProcessor::ghostCancellationLogicSLHC() {
      previous wire (this has not been done in 2003 test beam).  The
      cancellation is done separately for collision and accelerator patterns. */
 
+  // 1 if cancelled by the previous wire, 2 if by the next one.
   int ghost_cleared[CSCConstants::MAX_NUM_WIRES][2];
 
   for (int key_wire = 0; key_wire < numWireGroups; key_wire++) {
@@ -1160,7 +1465,7 @@ void CSCAnodeLCTProcessor::ghostCancellationLogicSLHC() {
             dt = first_bx[key_wire] - first_bx[key_wire+1];
           // Same cancellation logic as for the previous wire.
           if (dt == 0) {
-            if (qual_next >= qual_this) ghost_cleared[key_wire][i_pattern] = 1;
+            if (qual_next >= qual_this) ghost_cleared[key_wire][i_pattern] = 2;
           }
           else if (dt > 0 && dt <= ghost_cancellation_bx_depth ) {
             // Next "if" check accounts for firmware bug and should be
@@ -1170,10 +1475,10 @@ void CSCAnodeLCTProcessor::ghostCancellationLogicSLHC() {
             ////if (qual_next > qual_this)
             if ((!ghost_cancellation_side_quality) ||
                 (qual_next >= qual_this) )
-              ghost_cleared[key_wire][i_pattern] = 1;
+              ghost_cleared[key_wire][i_pattern] = 2;
           }
         }
-        if (ghost_cleared[key_wire][i_pattern] == 1) {
+        if (ghost_cleared[key_wire][i_pattern] == 2) {
           if (infoV > 1) LogTrace("CSCAnodeLCTProcessor")
             << ((i_pattern == 0) ? "Accelerator" : "Collision")
             << " pattern ghost cancelled on key_wire " << key_wire <<" q="<<qual_this
@@ -1189,6 +1494,12 @@ void CSCAnodeLCTProcessor::ghostCancellationLogicSLHC() {
   for (int key_wire = 0; key_wire < numWireGroups; key_wire++) {
     for (int i_pattern = 0; i_pattern < 2; i_pattern++) {
       if (ghost_cleared[key_wire][i_pattern] > 0) {
+        CSCTP_COUNT(theStation, theRing, GHOSTS, 1);
+        if (trace) trace->record(traceId, CSCTriggerTrace::ALCT,
+                                 CSCTriggerTrace::GHOST_CANCEL, first_bx[key_wire],
+                                 key_wire, i_pattern,
+                                 (ghost_cleared[key_wire][i_pattern] == 1) ?
+                                   key_wire-1 : key_wire+1);
         clear(key_wire, i_pattern);
       }
     }
@@ -1294,6 +1605,16 @@ void CSCAnodeLCTProcessor::lctSearch() {
   }
 
   for (int bx = 0; bx < MAX_ALCT_BINS; bx++) {
+    if (trace) {
+      if (bestALCT[bx].isValid())
+        trace->record(traceId, CSCTriggerTrace::ALCT, CSCTriggerTrace::LATCH, bx,
+                      bestALCT[bx].getKeyWG(), bestALCT[bx].getAccelerator(),
+                      bestALCT[bx].getQuality());
+      if (secondALCT[bx].isValid())
+        trace->record(traceId, CSCTriggerTrace::ALCT, CSCTriggerTrace::LATCH, bx,
+                      secondALCT[bx].getKeyWG(), secondALCT[bx].getAccelerator(),
+                      secondALCT[bx].getQuality());
+    }
     if (bestALCT[bx].isValid()) {
       bestALCT[bx].setTrknmb(1);
       if (infoV > 0) {
@@ -1571,7 +1892,7 @@ void CSCAnodeLCTProcessor::dumpDigis(const std::vector<int> wire[CSCConstants::N
     strstrm << "\n";
     for (int i_wire = 0; i_wire < numWireGroups; i_wire++) {
       if (wire[i_layer][i_wire].size() > 0) {
-        std::vector<int> bx_times = wire[i_layer][i_wire];
+        const std::vector<int>& bx_times = wire[i_layer][i_wire];
         strstrm << std::hex << bx_times[0] << std::dec;
       }
       else {
@@ -1582,21 +1903,29 @@ void CSCAnodeLCTProcessor::dumpDigis(const std::vector<int> wire[CSCConstants::N
   LogTrace("CSCAnodeLCTProcessor") << strstrm.str();
 }
 
-// Returns vector of read-out ALCTs, if any.  Starts with the vector of
-// all found ALCTs and selects the ones in the read-out time window.
+// Returns vector of read-out ALCTs, if any.
 std::vector<CSCALCTDigi> CSCAnodeLCTProcessor::readoutALCTs() {
   std::vector<CSCALCTDigi> tmpV;
+  readoutALCTs(tmpV);
+  return tmpV;
+}
 
+// Appends read-out ALCTs, if any, to the given vector.  Goes over all
+// found ALCTs, in the order of getALCTs(), and selects the ones in the
+// read-out time window.
+void CSCAnodeLCTProcessor::readoutALCTs(std::vector<CSCALCTDigi>& alcts) {
   // The number of LCT bins in the read-out is given by the
   // l1a_window_width parameter, but made even by setting the LSB of
   // l1a_window_width to 0.
-  static int lct_bins   = 
+  int lct_bins   = 
     //    (l1a_window_width%2 == 0) ? l1a_window_width : l1a_window_width-1;
     l1a_window_width;
-  static int late_tbins = early_tbins + lct_bins;
+  int late_tbins = early_tbins + lct_bins;
 
-  static int ifois = 0;
-  if (ifois == 0) {
+  if (late_tbins > MAX_ALCT_BINS-1) late_tbins = MAX_ALCT_BINS-1;
+
+  static std::atomic<bool> readout_checked(false);
+  if (!readout_checked.exchange(true)) {
 
     //std::cout<<"ALCT early_tbins="<<early_tbins<<"  lct_bins="<<lct_bins<<"  l1a_window_width="<<l1a_window_width<<"  late_tbins="<<late_tbins<<std::endl;
     //std::cout<<"**** ALCT readoutALCTs config dump ****"<<std::endl;
@@ -1608,21 +1937,19 @@ std::vector<CSCALCTDigi> CSCAnodeLCTProcessor::readoutALCTs() {
         << "; in-time ALCTs are not getting read-out!!! +++" << "\n";
     }
 
-    if (late_tbins > MAX_ALCT_BINS-1) {
+    if (early_tbins + lct_bins > MAX_ALCT_BINS-1) {
       if (infoV >= 0) edm::LogWarning("L1CSCTPEmulatorSuspiciousParameters")
-        << "+++ Allowed range of time bins, [0-" << late_tbins
+        << "+++ Allowed range of time bins, [0-" << early_tbins + lct_bins
         << "] exceeds max allowed, " << MAX_ALCT_BINS-1 << " +++\n"
         << "+++ Set late_tbins to max allowed +++\n";
-      late_tbins = MAX_ALCT_BINS-1;
     }
-    ifois = 1;
   }
 
-  // Start from the vector of all found ALCTs and select those within
-  // the ALCT*L1A coincidence window.
-  std::vector<CSCALCTDigi> all_alcts = getALCTs();
-  for (std::vector <CSCALCTDigi>::const_iterator plct = all_alcts.begin();
-       plct != all_alcts.end(); plct++) {
+  // Go over all found ALCTs and select those within the ALCT*L1A
+  // coincidence window.
+  for (int i_lct = 0; i_lct < 2*MAX_ALCT_BINS; i_lct++) {
+    const CSCALCTDigi* plct =
+      (i_lct%2 == 0) ? &bestALCT[i_lct/2] : &secondALCT[i_lct/2];
     if (!plct->isValid()) continue;
 
     int bx = (*plct).getBX();
@@ -1644,9 +1971,8 @@ std::vector<CSCALCTDigi> CSCAnodeLCTProcessor::readoutALCTs() {
       continue;
     }
 
-    tmpV.push_back(*plct);
+    alcts.push_back(*plct);
   }
-  return tmpV;
 }
 
 // Returns vector of all found ALCTs, if any.  Used in ALCT-CLCT matching.
@@ -1673,11 +1999,11 @@ void CSCAnodeLCTProcessor::showPatterns(const int key_wire) {
       strstrm_header << ((32-i)%10);
     }
     LogTrace("CSCAnodeLCTProcessor") << strstrm_header.str();
-    for (int i_wire = 0; i_wire < NUM_PATTERN_WIRES; i_wire++) {
-      if (pattern_mask[i_pattern][i_wire] != 0) {
+    const int* layer_begin = pattern_cells->layer_begin[i_pattern];
+    for (int this_layer = 0; this_layer < CSCConstants::NUM_LAYERS; this_layer++) {
+      for (int i_cell = layer_begin[this_layer]; i_cell < layer_begin[this_layer+1]; i_cell++) {
         std::ostringstream strstrm_pulse;
-        int this_layer = pattern_envelope[0][i_wire];
-        int this_wire  = pattern_envelope[1+MESelection][i_wire]+key_wire;
+        int this_wire  = pattern_cells->delta_wire[i_pattern][i_cell]+key_wire;
         if (this_wire >= 0 && this_wire < numWireGroups) {
           for (int i = 1; i <= 32; i++) {
             strstrm_pulse << ((pulse[this_layer][this_wire]>>(32-i)) & 1);
@@ -18,11 +18,15 @@
  */
 
 #include <vector>
+#include <bitset>
 #include <FWCore/ParameterSet/interface/ParameterSet.h>
 #include <DataFormats/CSCDigi/interface/CSCWireDigiCollection.h>
 #include <DataFormats/CSCDigi/interface/CSCALCTDigi.h>
 #include <CondFormats/CSCObjects/interface/CSCDBL1TPParameters.h>
 #include <L1Trigger/CSCCommonTrigger/interface/CSCConstants.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCChamberGeometryInfo.h>
+
+class CSCTriggerTrace;
 
 class CSCAnodeLCTProcessor
 {
@@ -39,6 +43,23 @@ class CSCAnodeLCTProcessor
   /** Sets configuration parameters obtained via EventSetup mechanism. */
   void setConfigParameters(const CSCDBL1TPParameters* conf);
 
+  /** Sets the number of wire groups from a snapshot of the chamber
+      geometry; done when the geometry changes.  Without it, the
+      processor built by the normal constructor does not run. */
+  void setChamberGeometry(const CSCChamberGeometryInfo& info);
+
+  /** Sets the verbosity level (see infoV); used in standalone tests. */
+  void setVerbosity(const int verbosity) {infoV = verbosity;}
+
+  /** Sets the upgrade and ME1/1 flags of the common parameters, for the
+      processor of the upgrade ME1/1 TMB built by its test constructor. */
+  void setME11Flags(const bool slhc, const bool disable_me1a)
+    {isSLHC = slhc; disableME1a = disable_me1a;}
+
+  /** Records the decisions of this processor into the given trace; 0
+      turns tracing off. */
+  void setTrace(CSCTriggerTrace* trace);
+
   /** Clears the LCT containers. */
   void clear();
 
@@ -54,6 +75,12 @@ class CSCAnodeLCTProcessor
   bool getDigis(const CSCWireDigiCollection* wiredc);
   void getDigis(const CSCWireDigiCollection* wiredc, const CSCDetId& id);
 
+  /** Fills the wire times from the given wire digis of each layer, as
+      run(wiredc) does; lets standalone programs pass the digis of a
+      chamber to run(wire) without a digi collection. */
+  void readWireDigis(const std::vector<CSCWireDigi> digis[CSCConstants::NUM_LAYERS],
+                     std::vector<int> wire[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES]);
+
   /** Maximum number of time bins reported in the ALCT readout. */
   enum {MAX_ALCT_BINS = 16};
 
@@ -70,12 +97,20 @@ class CSCAnodeLCTProcessor
   /** Returns vector of ALCTs in the read-out time window, if any. */
   std::vector<CSCALCTDigi> readoutALCTs();
 
+  /** Appends the ALCTs in the read-out time window, if any, to the given
+      vector. */
+  void readoutALCTs(std::vector<CSCALCTDigi>& alcts);
+
   /** Returns vector of all found ALCTs, if any. */
   std::vector<CSCALCTDigi> getALCTs();
 
   /** set ring number. Important only for ME1a */
   void setRing(unsigned r) {theRing = r;}
 
+  /** Id of the chamber whose digis the processor reads. */
+  CSCDetId chamberId() const
+    {return CSCDetId(theEndcap, theStation, theRing, theChamber, 0);}
+
   /** Pre-defined patterns. */
   enum {NUM_PATTERN_WIRES = 14};
   static const int pattern_envelope[CSCConstants::NUM_ALCT_PATTERNS][NUM_PATTERN_WIRES];
@@ -91,6 +126,10 @@ class CSCAnodeLCTProcessor
    *                   3: add special-purpose prints. */
   int infoV;
 
+  /** Trace of this chamber, if it is traced, and its raw id. */
+  CSCTriggerTrace* trace;
+  uint32_t traceId;
+
   /** Chamber id (trigger-type labels). */
   const unsigned theEndcap;
   const unsigned theStation;
@@ -114,11 +153,16 @@ class CSCAnodeLCTProcessor
   int numWireGroups;
   int MESelection;
 
-  int first_bx[CSCConstants::MAX_NUM_WIRES];
-  int first_bx_corrected[CSCConstants::MAX_NUM_WIRES];
-  int quality[CSCConstants::MAX_NUM_WIRES][3];
-  std::vector<CSCWireDigi> digiV[CSCConstants::NUM_LAYERS];
-  unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES];
+  /** Working arrays of run(); they point into the scratch arena of the
+      thread the processor runs on, see attachScratch(). */
+  int* first_bx;
+  int* first_bx_corrected;
+  int (*quality)[3];
+  std::vector<CSCWireDigi>* digiV;
+  unsigned int (*pulse)[CSCConstants::MAX_NUM_WIRES];
+
+  /** Hit times on wire groups. */
+  std::vector<int> (*wire_times)[CSCConstants::MAX_NUM_WIRES];
 
   /** Flag for MTCC data (i.e., "open" patterns). */
   bool isMTCC;
@@ -160,6 +204,51 @@ class CSCAnodeLCTProcessor
   /** SLHC: whether to use narrow pattern mask for the rings close to the beam */
   bool narrow_mask_r1;
 
+  /** Whether to find pretriggers and count pattern layers for all key
+      wires at once, with bit operations on wire-group bitsets. */
+  bool use_bit_parallel;
+
+  /** Bit-parallel engine: one bit per wire group (key wire). */
+  typedef std::bitset<CSCConstants::MAX_NUM_WIRES> WireBits;
+
+  /** Number of time bins in a pulse. */
+  enum {NUM_PULSE_BX = 32};
+
+  /** Bit-parallel engine: number of layers hit in each pattern for every
+      key wire and bx, as three bit slices (LSB first). */
+  WireBits (*pattern_layers)[NUM_PULSE_BX][3];
+
+  /** Bit-parallel engine: key wires satisfying the pretrigger threshold of
+      each pattern at every bx. */
+  WireBits (*pretrig_keys)[NUM_PULSE_BX];
+
+  /** Storage of the working arrays.  Their contents only live during one
+      call to run(), so one arena per thread is shared by all the ALCT
+      processors run on that thread; the vectors in it keep their
+      capacity from chamber to chamber. */
+  struct Scratch {
+    int first_bx[CSCConstants::MAX_NUM_WIRES];
+    int first_bx_corrected[CSCConstants::MAX_NUM_WIRES];
+    int quality[CSCConstants::MAX_NUM_WIRES][3];
+    std::vector<CSCWireDigi> digiV[CSCConstants::NUM_LAYERS];
+    unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES];
+    std::vector<int> wire_times[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES];
+    WireBits pattern_layers[CSCConstants::NUM_ALCT_PATTERNS][NUM_PULSE_BX][3];
+    WireBits pretrig_keys[CSCConstants::NUM_ALCT_PATTERNS][NUM_PULSE_BX];
+
+    /** Processor the arrays were last attached to. */
+    const CSCAnodeLCTProcessor* owner;
+
+    Scratch() : owner(0) {}
+  };
+
+  /** Scratch arena of the calling thread. */
+  static Scratch& threadScratch();
+
+  /** Point the working arrays to the scratch arena of the calling thread;
+      done on entry to run() and getDigis(). */
+  void attachScratch();
+
   /** Default values of configuration parameters. */
   static const unsigned int def_fifo_tbins, def_fifo_pretrig;
   static const unsigned int def_drift_delay;
@@ -169,10 +258,27 @@ class CSCAnodeLCTProcessor
   static const unsigned int def_trig_mode, def_accel_mode;
   static const unsigned int def_l1a_window_width;
 
-  /** Chosen pattern mask. */
-  int pattern_mask[CSCConstants::NUM_ALCT_PATTERNS][NUM_PATTERN_WIRES];
+  /** Pattern masks applied to the envelope. */
+  enum PatternMaskType {MASK_SLIM, MASK_OPEN, MASK_R1, NUM_PATTERN_MASKS};
+
+  /** Cells of the masked patterns in the form the pattern loops use: for
+      every pattern, the key-wire offsets of the cells in the mask, grouped
+      by layer.  The cells of layer l are [layer_begin[l], layer_begin[l+1]). */
+  struct PatternCells {
+    int layer_begin[CSCConstants::NUM_ALCT_PATTERNS][CSCConstants::NUM_LAYERS+1];
+    int delta_wire[CSCConstants::NUM_ALCT_PATTERNS][NUM_PATTERN_WIRES];
+  };
 
-  /** Load pattern mask defined by configuration into pattern_mask */
+  /** Pattern cells for a mask and MESelection; built once from the static
+      tables above and shared by all the processors. */
+  static const PatternCells& patternCells(const int mask_type,
+                                          const int me_selection);
+  static std::vector<PatternCells> buildPatternCells();
+
+  /** Chosen pattern cells. */
+  const PatternCells* pattern_cells;
+
+  /** Point pattern_cells to the mask defined by configuration. */
   void loadPatternMask();
 
   /** Set default values for configuration parameters. */
@@ -189,6 +295,21 @@ class CSCAnodeLCTProcessor
   bool pulseExtension(const std::vector<int> wire[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES]);
   bool preTrigger(const int key_wire, const int start_bx);
   bool patternDetection(const int key_wire);
+
+  /** Pattern detection specialized at compile time on the layer counting
+      (cell-by-cell or bit-parallel) and on the quality definition (TMB07
+      or earlier); the variant is chosen once by selectAlgorithm(). */
+  template <bool BitParallel, bool TMB07>
+  bool patternDetectionKernel(const int key_wire);
+  typedef bool (CSCAnodeLCTProcessor::*PatternDetectionKernel)(const int key_wire);
+  PatternDetectionKernel pattern_detection;
+
+  /** Select the algorithm variants for the current configuration. */
+  void selectAlgorithm();
+  void fillPatternBits();
+  unsigned int patternLayers(const int key_wire, const int i_pattern,
+                             const unsigned int bx_time) const;
+  int pulseStartBx(const int layer, const int wire, const int bx_time) const;
   void ghostCancellationLogic();
   void ghostCancellationLogicSLHC();
   void lctSearch();
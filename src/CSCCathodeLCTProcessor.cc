@@ -26,14 +26,19 @@
 //-----------------------------------------------------------------------------
 
 #include <L1Trigger/CSCTriggerPrimitives/src/CSCCathodeLCTProcessor.h>
-#include <L1Trigger/CSCCommonTrigger/interface/CSCTriggerGeometry.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCMedianBx.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesStats.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerTrace.h>
 #include <DataFormats/MuonDetId/interface/CSCTriggerNumbering.h>
 
 #include <FWCore/MessageLogger/interface/MessageLogger.h>
+#include "tbb/enumerable_thread_specific.h"
 #include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
-#include <set>
 
 //-----------------
 // Static variables
@@ -244,8 +249,6 @@ CSCCathodeLCTProcessor::CSCCathodeLCTProcessor(unsigned endcap,
 					       const edm::ParameterSet& ctmb) :
 		     theEndcap(endcap), theStation(station), theSector(sector),
                      theSubsector(subsector), theTrigChamber(chamber) {
-  static bool config_dumped = false;
-
   // CLCT configuration parameters.
   fifo_tbins   = conf.getParameter<unsigned int>("clctFifoTbins");
   hit_persist  = conf.getParameter<unsigned int>("clctHitPersist");
@@ -286,6 +289,9 @@ CSCCathodeLCTProcessor::CSCCathodeLCTProcessor(unsigned endcap,
     start_bx_shift = conf.getUntrackedParameter<int>("clctStartBxShift",0);
   }
 
+  // whether to use the bit-parallel pattern finding
+  use_bit_parallel = conf.getUntrackedParameter<bool>("clctBitParallelPatterns",false);
+
   if (smartME1aME1b) {
     // use of localized dead-time zones
     use_dead_time_zoning = 
@@ -309,7 +315,7 @@ CSCCathodeLCTProcessor::CSCCathodeLCTProcessor(unsigned endcap,
 
   // separate handle for early time bins
   early_tbins = ctmb.getUntrackedParameter<int>("tmbEarlyTbins",-1);
-  static int fpga_latency = 3;
+  const int fpga_latency = 3;
   if (early_tbins<0) early_tbins  = fifo_pretrig - fpga_latency;
 
   // wether to readout only the earliest two LCTs in readout window
@@ -320,13 +326,15 @@ CSCCathodeLCTProcessor::CSCCathodeLCTProcessor(unsigned endcap,
 
   // Check and print configuration parameters.
   checkConfigParameters();
-  if ((infoV > 0 || isSLHC) && !config_dumped) {
+  // Dumped once per process, by whichever board gets here first.
+  static std::atomic<bool> config_dumped(false);
+  if ((infoV > 0 || isSLHC) && !config_dumped.exchange(true)) {
     //std::cerr<<"**** CLCT constructor parameters dump ****"<<std::endl;
     dumpConfigParams();
-    config_dumped = true;
   }
 
-  numStrips = 0; // Will be set later.
+  geomStrips = 0; // Will be set later.
+  numStrips = 0;
   // Provisional, but should be OK for all stations except ME1.
   for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
     if ((i_layer+1)%2 == 0) stagger[i_layer] = 0;
@@ -348,6 +356,14 @@ CSCCathodeLCTProcessor::CSCCathodeLCTProcessor(unsigned endcap,
   // trigger numbering doesn't distinguish between ME1a and ME1b chambers:
   isME11 = (theStation == 1 && theRing == 1);
 
+  trace = 0;
+  traceId = 0;
+
+  // Pick the algorithm variant for this configuration.
+  selectAlgorithm();
+
+  attachScratch();
+
   //if (theStation==1 && theRing==2) infoV = 3;
 
   ////engage in various and sundry tests, but only for a single chamber.
@@ -367,13 +383,12 @@ CSCCathodeLCTProcessor::CSCCathodeLCTProcessor() :
   		     theEndcap(1), theStation(1), theSector(1),
                      theSubsector(1), theTrigChamber(1) {
   // constructor for debugging.
-  static bool config_dumped = false;
-
   // CLCT configuration parameters.
   setDefaultConfigParameters();
   infoV =  2;
   isMTCC  = false;
   isTMB07 = true;
+  isSLHC  = false;
 
   smartME1aME1b = false;
   disableME1a = false;
@@ -384,15 +399,21 @@ CSCCathodeLCTProcessor::CSCCathodeLCTProcessor() :
   start_bx_shift = 0;
   use_dead_time_zoning = 1;
   clct_state_machine_zone = 8;
+  dynamic_state_machine_zone = true;
+  pretrig_trig_zone = 5;
+
+  use_bit_parallel = false;
+  use_corrected_bx = false;
   
   // Check and print configuration parameters.
   checkConfigParameters();
-  if (!config_dumped) {
+  static std::atomic<bool> config_dumped(false);
+  if (!config_dumped.exchange(true)) {
     //std::cerr<<"**** CLCT default constructor parameters dump ****"<<std::endl;
     dumpConfigParams();
-    config_dumped = true;
   }
 
+  geomStrips = CSCConstants::MAX_NUM_STRIPS;
   numStrips = CSCConstants::MAX_NUM_STRIPS;
   // Should be OK for all stations except ME1.
   for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
@@ -401,7 +422,126 @@ CSCCathodeLCTProcessor::CSCCathodeLCTProcessor() :
   }
   
   theRing = CSCTriggerNumbering::ringFromTriggerLabels(theStation, theTrigChamber);
+  theChamber = CSCTriggerNumbering::chamberFromTriggerLabels(theSector, theSubsector,
+                                                             theStation, theTrigChamber);
   isME11 = (theStation == 1 && theRing == 1);
+
+  trace = 0;
+  traceId = 0;
+
+  selectAlgorithm();
+
+  attachScratch();
+}
+
+CSCCathodeLCTProcessor::Scratch& CSCCathodeLCTProcessor::threadScratch() {
+  // The arena of a thread is created the first time a CLCT processor is
+  // run on it.  A thread runs one chamber at a time, so the processors
+  // sharing an arena never use it concurrently.
+  static tbb::enumerable_thread_specific<Scratch> arenas;
+  return arenas.local();
+}
+
+void CSCCathodeLCTProcessor::attachScratch() {
+  Scratch& scratch   = threadScratch();
+  digiV              = scratch.digiV;
+  halfstrip_times    = scratch.halfstrip_times;
+  distrip_times      = scratch.distrip_times;
+  best_pid           = scratch.best_pid;
+  nhits              = scratch.nhits;
+  first_bx_corrected = scratch.first_bx_corrected;
+  ispretrig          = scratch.ispretrig;
+  scratch.owner      = this;
+}
+
+void CSCCathodeLCTProcessor::selectAlgorithm() {
+  // The firmware generation and the feature flags are fixed for the
+  // lifetime of the processor, so the algorithm and the pattern finding
+  // kernel are chosen here once rather than in every call.
+  if (isTMB07) {
+    // Upgrade version for ME11 with better dead-time handling
+    if (isSLHC && smartME1aME1b && isME11 && use_dead_time_zoning)
+      algo_version = ALGO_SLHC;
+    else
+      algo_version = ALGO_TMB07;
+  }
+  else if (isMTCC) algo_version = ALGO_MTCC;
+  else             algo_version = ALGO_IDEALIZED;
+
+  pattern_cells = &patternCells2007();
+
+  // The median start time of the pattern hits is only used by the SLHC
+  // algorithm, as the bx or as the full bx of the CLCT depending on
+  // use_corrected_bx, and in the debug printout.
+  const bool corrected_bx = algo_version == ALGO_SLHC || infoV > 1;
+  if (use_bit_parallel) {
+    if (corrected_bx) ptn_finding_kernel = &CSCCathodeLCTProcessor::ptnFindingBitParallel<true>;
+    else              ptn_finding_kernel = &CSCCathodeLCTProcessor::ptnFindingBitParallel<false>;
+  }
+  else {
+    if (corrected_bx) ptn_finding_kernel = &CSCCathodeLCTProcessor::ptnFindingScalar<true>;
+    else              ptn_finding_kernel = &CSCCathodeLCTProcessor::ptnFindingScalar<false>;
+  }
+}
+
+const CSCCathodeLCTProcessor::PatternCells&
+CSCCathodeLCTProcessor::patternCells2007() {
+  // Built on first use (the initialization of a local static is
+  // thread-safe); read-only afterwards.  Derived from pattern2007 at run
+  // time for the same reason as the ALCT pattern cells: the pattern arrays
+  // are not usable in constant expressions.
+  static const PatternCells cells = buildPatternCells2007();
+  return cells;
+}
+
+CSCCathodeLCTProcessor::PatternCells
+CSCCathodeLCTProcessor::buildPatternCells2007() {
+  // Keep the cells of every pattern which belong to a layer, layer by
+  // layer; unused cells (999) and pid=0 are skipped.
+  PatternCells cells;
+  for (int pid = 0; pid < CSCConstants::NUM_CLCT_PATTERNS; pid++) {
+    int n_cells = 0;
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+      cells.layer_begin[pid][i_layer] = n_cells;
+      for (int strip_num = 0; strip_num < NUM_PATTERN_HALFSTRIPS; strip_num++) {
+	if (pattern2007[pid][strip_num] != i_layer) continue;
+	cells.offset[pid][n_cells++] = pattern2007_offset[strip_num];
+      }
+    }
+    cells.layer_begin[pid][CSCConstants::NUM_LAYERS] = n_cells;
+  }
+  return cells;
+}
+
+void CSCCathodeLCTProcessor::setVerbosity(const int verbosity) {
+  infoV = verbosity;
+  // The pattern finding kernel depends on the verbosity.
+  selectAlgorithm();
+}
+
+void CSCCathodeLCTProcessor::setME11Flags(const bool slhc, const bool smart,
+					  const bool disable_me1a,
+					  const bool ganged_me1a) {
+  isSLHC = slhc;
+  smartME1aME1b = smart;
+  disableME1a = disable_me1a;
+  gangedME1a = ganged_me1a;
+  // The split of the ME1/1 strips and the algorithm depend on these flags;
+  // the split is made again from the number of strips of the chamber.
+  if (isME11 && geomStrips > 0) {
+    CSCChamberGeometryInfo info;
+    info.exists = true;
+    info.numStrips = geomStrips;
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
+      info.stagger[i_layer] = stagger[i_layer];
+    setChamberGeometry(info);
+  }
+  selectAlgorithm();
+}
+
+void CSCCathodeLCTProcessor::setTrace(CSCTriggerTrace* t) {
+  trace = t;
+  traceId = CSCDetId(theEndcap, theStation, theRing, theChamber, 0).rawId();
 }
 
 void CSCCathodeLCTProcessor::setDefaultConfigParameters() {
@@ -427,7 +567,6 @@ void CSCCathodeLCTProcessor::setDefaultConfigParameters() {
 
 // Set configuration parameters obtained via EventSetup mechanism.
 void CSCCathodeLCTProcessor::setConfigParameters(const CSCDBL1TPParameters* conf) {
-  static bool config_dumped = false;
 
   fifo_tbins   = conf->clctFifoTbins();
   fifo_pretrig = conf->clctFifoPretrig();
@@ -444,10 +583,10 @@ void CSCCathodeLCTProcessor::setConfigParameters(const CSCDBL1TPParameters* conf
 
   // Check and print configuration parameters.
   checkConfigParameters();
-  if (!config_dumped) {
+  static std::atomic<bool> config_dumped(false);
+  if (!config_dumped.exchange(true)) {
     //std::cerr<<"**** CLCT setConfigParams parameters dump ****"<<std::endl;
     dumpConfigParams();
-    config_dumped = true;
   }
 }
 
@@ -544,6 +683,69 @@ void CSCCathodeLCTProcessor::checkConfigParameters() {
   }
 }
 
+void CSCCathodeLCTProcessor::setChamberGeometry(const CSCChamberGeometryInfo& info) {
+  if (info.exists) {
+    geomStrips = info.numStrips;
+    numStrips = geomStrips;
+    // ME1/a is known to the readout hardware as strips 65-80 of ME1/1.
+    // Still need to decide whether we do any special adjustments to
+    // reconstruct LCTs in this region (3:1 ganged strips); for now, we
+    // simply allow for hits in ME1/a and apply standard reconstruction
+    // to them.
+    // For SLHC ME1/1 is set to have 4 CFEBs in ME1/b and 3 CFEBs in ME1/a
+    if (isME11) {
+      if (!smartME1aME1b && theRing == 1)
+      {
+	if (disableME1a) numStrips = 64;
+	else 
+	{
+	  if (gangedME1a) numStrips = 80;
+	  else numStrips = 112;
+	}
+      }
+      if ( smartME1aME1b && !disableME1a && theRing == 1 ) numStrips = 64;
+      if ( smartME1aME1b && !disableME1a && theRing == 4 ) {
+	if (gangedME1a) numStrips = 16;
+	else numStrips = 48;
+      }
+    }
+
+    if (numStrips > CSCConstants::MAX_NUM_STRIPS) {
+      if (infoV >= 0) edm::LogError("L1CSCTPEmulatorSetupError")
+	<< "+++ Number of strips, " << numStrips
+	<< " found in " << theMEStr << " " << theTrigStr
+	<< " exceeds max expected, " << CSCConstants::MAX_NUM_STRIPS
+	<< " +++\n" 
+	<< "+++ CSC geometry looks garbled; no emulation possible +++\n";
+      numStrips = -1;
+    }
+    // The strips for a given layer may be offset from the adjacent layers.
+    // This was done in order to improve resolution.  We need to find the
+    // 'staggering' for each layer and make necessary conversions in our
+    // arrays.  -JM
+    // In the TMB-07 firmware, half-strips in odd layers (layers are
+    // counted as ly0-ly5) are shifted by -1 half-strip, whereas in
+    // the previous firmware versions half-strips in even layers
+    // were shifted by +1 half-strip.  This difference is due to a
+    // change from ly3 to ly2 in the choice of the key layer, and
+    // the intention to keep half-strips in the key layer unchanged.
+    // In the emulator, we use the old way for both cases, to avoid
+    // negative half-strip numbers.  This will necessitate a
+    // subtraction of 1 half-strip for TMB-07 later on. -SV.
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+      stagger[i_layer] = info.stagger[i_layer];
+    }
+  }
+  else {
+    if (infoV >= 0) edm::LogError("L1CSCTPEmulatorConfigError")
+      << " " << theMEStr << " " << theTrigStr
+      << " is not defined in current geometry! +++\n"
+      << "+++ CSC geometry looks garbled; no emulation possible +++\n";
+    geomStrips = 0;
+    numStrips = -1;
+  }
+}
+
 void CSCCathodeLCTProcessor::clear() {
   thePreTriggerBXs.clear();
   for (int bx = 0; bx < MAX_CLCT_BINS; bx++) {
@@ -560,81 +762,18 @@ CSCCathodeLCTProcessor::run(const CSCComparatorDigiCollection* compdc) {
 
   // clear(); // redundant; called by L1MuCSCMotherboard.
 
-  static bool config_dumped = false;
-  if ((infoV > 0 || isSLHC) && !config_dumped) {
+  attachScratch();
+
+  static std::atomic<bool> config_dumped(false);
+  if ((infoV > 0 || isSLHC) && !config_dumped.exchange(true)) {
     //std::cerr<<"**** CLCT run parameters dump ****"<<std::endl;
     dumpConfigParams();
-    config_dumped = true;
-  }
-
-  // Get the number of strips and stagger of layers for the given chamber.
-  // Do it only once per chamber.
-  if (numStrips == 0) {
-    CSCTriggerGeomManager* theGeom = CSCTriggerGeometry::get();
-    CSCChamber* chamber = theGeom->chamber(theEndcap, theStation, theSector,
-					      theSubsector, theTrigChamber);
-    if (chamber) {
-      numStrips = chamber->layer(1)->geometry()->numberOfStrips();
-      // ME1/a is known to the readout hardware as strips 65-80 of ME1/1.
-      // Still need to decide whether we do any special adjustments to
-      // reconstruct LCTs in this region (3:1 ganged strips); for now, we
-      // simply allow for hits in ME1/a and apply standard reconstruction
-      // to them.
-      // For SLHC ME1/1 is set to have 4 CFEBs in ME1/b and 3 CFEBs in ME1/a
-      if (isME11) {
-	if (!smartME1aME1b && theRing == 1)
-        {
-	  if (disableME1a) numStrips = 64;
-          else 
-          {
-            if (gangedME1a) numStrips = 80;
-            else numStrips = 112;
-          }
-        }
-	if ( smartME1aME1b && !disableME1a && theRing == 1 ) numStrips = 64;
-	if ( smartME1aME1b && !disableME1a && theRing == 4 ) {
-	  if (gangedME1a) numStrips = 16;
-	  else numStrips = 48;
-	}
-      }
-
-      if (numStrips > CSCConstants::MAX_NUM_STRIPS) {
-	if (infoV >= 0) edm::LogError("L1CSCTPEmulatorSetupError")
-	  << "+++ Number of strips, " << numStrips
-	  << " found in " << theMEStr << " " << theTrigStr
-	  << " exceeds max expected, " << CSCConstants::MAX_NUM_STRIPS
-	  << " +++\n" 
-	  << "+++ CSC geometry looks garbled; no emulation possible +++\n";
-	numStrips = -1;
-      }
-      // The strips for a given layer may be offset from the adjacent layers.
-      // This was done in order to improve resolution.  We need to find the
-      // 'staggering' for each layer and make necessary conversions in our
-      // arrays.  -JM
-      // In the TMB-07 firmware, half-strips in odd layers (layers are
-      // counted as ly0-ly5) are shifted by -1 half-strip, whereas in
-      // the previous firmware versions half-strips in even layers
-      // were shifted by +1 half-strip.  This difference is due to a
-      // change from ly3 to ly2 in the choice of the key layer, and
-      // the intention to keep half-strips in the key layer unchanged.
-      // In the emulator, we use the old way for both cases, to avoid
-      // negative half-strip numbers.  This will necessitate a
-      // subtraction of 1 half-strip for TMB-07 later on. -SV.
-      for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
-	stagger[i_layer] =
-	  (chamber->layer(i_layer+1)->geometry()->stagger() + 1) / 2;
-      }
-    }
-    else {
-      if (infoV >= 0) edm::LogError("L1CSCTPEmulatorConfigError")
-	<< " " << theMEStr << " " << theTrigStr
-	<< " is not defined in current geometry! +++\n"
-	<< "+++ CSC geometry looks garbled; no emulation possible +++\n";
-      numStrips = -1;
-    }
   }
 
-  if (numStrips < 0) {
+  // The number of strips and the stagger of layers come from the geometry
+  // snapshot handed over by the builder; numStrips is still 0 if there was
+  // none.
+  if (numStrips <= 0) {
     if (infoV >= 0) edm::LogError("L1CSCTPEmulatorConfigError")
       << " " << theMEStr << " " << theTrigStr
       << ": numStrips = " << numStrips << "; CLCT emulation skipped! +++";
@@ -647,15 +786,24 @@ CSCCathodeLCTProcessor::run(const CSCComparatorDigiCollection* compdc) {
 
   if (!noDigis) {
     // Get halfstrip (and possibly distrip) times from comparator digis.
-    std::vector<int>
-      halfstrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
-    std::vector<int>
-      distrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
-    if (isTMB07) { // TMB07 (latest) version: halfstrips only.
-      readComparatorDigis(halfstrip);
+    // The arrays of times are kept in the scratch arena so that no memory
+    // is allocated once their capacity has grown.
+    std::vector<int> (*halfstrip)[CSCConstants::NUM_HALF_STRIPS] = halfstrip_times;
+    std::vector<int> (*distrip)[CSCConstants::NUM_HALF_STRIPS] = distrip_times;
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+      for (int i_hstrip = 0; i_hstrip < CSCConstants::NUM_HALF_STRIPS; i_hstrip++) {
+	halfstrip[i_layer][i_hstrip].clear();
+	distrip[i_layer][i_hstrip].clear();
+      }
     }
-    else { // Earlier versions: halfstrips and distrips.
-      readComparatorDigis(halfstrip, distrip);
+    {
+      CSCTP_TIME(theStation, theRing, READ_COMPARATOR_DIGIS);
+      if (isTMB07) { // TMB07 (latest) version: halfstrips only.
+	readComparatorDigis(halfstrip);
+      }
+      else { // Earlier versions: halfstrips and distrips.
+	readComparatorDigis(halfstrip, distrip);
+      }
     }
 
     // Pass arrays of halfstrips and distrips on to another run() doing the
@@ -693,16 +841,27 @@ void CSCCathodeLCTProcessor::run(
   // are returned.
   std::vector<CSCCLCTDigi> LCTlist;
 
-  if (isTMB07) {
-    // Upgrade version for ME11 with better dead-time handling
-    if (isSLHC && smartME1aME1b && isME11 && use_dead_time_zoning) LCTlist = findLCTsSLHC(halfstrip);
-    // TMB07 version of the CLCT algorithm.
-    else LCTlist = findLCTs(halfstrip);
-  }
-  else if (isMTCC) { // MTCC version.
+  attachScratch();
+
+  CSCTP_TIME(theStation, theRing, FIND_LCTS);
+  switch (algo_version) {
+  case ALGO_SLHC: // Upgrade version for ME11 with better dead-time handling
+    // preTrigger() sets the pretrigger flags of the half-strips of this
+    // chamber before they are read, as in the original code, but the SLHC
+    // algorithm reads them over the full NUM_HALF_STRIPS range.  The
+    // flags beyond the chamber were never set and only ever read as
+    // false; since the arena may come from a chamber with more
+    // half-strips, clear them so that this still holds.
+    std::fill(ispretrig, ispretrig + CSCConstants::NUM_HALF_STRIPS, false);
+    LCTlist = findLCTsSLHC(halfstrip);
+    break;
+  case ALGO_TMB07: // TMB07 version of the CLCT algorithm.
+    LCTlist = findLCTs(halfstrip);
+    break;
+  case ALGO_MTCC: // MTCC version.
     LCTlist = findLCTs(halfstrip, distrip);
-  }
-  else { // Idealized algorithm of many years ago.
+    break;
+  case ALGO_IDEALIZED: { // Idealized algorithm of many years ago.
     std::vector<CSCCLCTDigi> halfStripLCTs = findLCTs(halfstrip, 1);
     std::vector<CSCCLCTDigi> diStripLCTs   = findLCTs(distrip,   0);
     // Put all the candidates into a single vector and sort them.
@@ -710,8 +869,15 @@ void CSCCathodeLCTProcessor::run(
       LCTlist.push_back(halfStripLCTs[i]);
     for (unsigned int i = 0; i < diStripLCTs.size(); i++)
       LCTlist.push_back(diStripLCTs[i]);
+    break;
+  }
   }
 
+  // The working arrays are done with.  They must not have been taken over
+  // by another processor in the meantime, as they would be if this thread
+  // ran a stolen task of another chamber in the middle of this one.
+  assert(threadScratch().owner == this);
+
   // LCT sorting.
   if (LCTlist.size() > 1)
     sort(LCTlist.begin(), LCTlist.end(), std::greater<CSCCLCTDigi>());
@@ -733,7 +899,7 @@ void CSCCathodeLCTProcessor::run(
       // CLCT was found in both half- and di-strip pattern search).
       // This can never happen in the test beam and MTCC
       // implementations.
-      if (!isMTCC && !isTMB07 && *plct == bestCLCT[bx]) continue;
+      if (algo_version == ALGO_IDEALIZED && *plct == bestCLCT[bx]) continue;
       secondCLCT[bx] = *plct;
     }
   }
@@ -756,6 +922,7 @@ void CSCCathodeLCTProcessor::run(
 
 bool CSCCathodeLCTProcessor::getDigis(const CSCComparatorDigiCollection* compdc) {
   bool noDigis = true;
+  attachScratch();
 
   // Loop over layers and save comparator digis on each one into digiV[layer].
   for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
@@ -804,6 +971,24 @@ void CSCCathodeLCTProcessor::getDigis(const CSCComparatorDigiCollection* compdc,
   }
 }
 
+void CSCCathodeLCTProcessor::readComparatorDigis(
+  const std::vector<CSCComparatorDigi> digis[CSCConstants::NUM_LAYERS],
+  std::vector<int> halfstrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+  std::vector<int> distrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS]) {
+  // Standalone version of getDigis() and readComparatorDigis(): the digis
+  // are given per layer instead of being looked up in a collection.
+  attachScratch();
+  for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+    digiV[i_layer].assign(digis[i_layer].begin(), digis[i_layer].end());
+    for (int i_hstrip = 0; i_hstrip < CSCConstants::NUM_HALF_STRIPS; i_hstrip++) {
+      halfstrip[i_layer][i_hstrip].clear();
+      distrip[i_layer][i_hstrip].clear();
+    }
+  }
+  if (isTMB07) readComparatorDigis(halfstrip);
+  else         readComparatorDigis(halfstrip, distrip);
+}
+
 void CSCCathodeLCTProcessor::readComparatorDigis(
         std::vector<int> halfstrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS]) {
   // Single-argument version for TMB07 (halfstrip-only) firmware.
@@ -814,6 +999,7 @@ void CSCCathodeLCTProcessor::readComparatorDigis(
     int i_digi = 0; // digi counter, for dumps.
     for (std::vector<CSCComparatorDigi>::iterator pld = digiV[i_layer].begin();
 	 pld != digiV[i_layer].end(); pld++, i_digi++) {
+      CSCTP_COUNT(theStation, theRing, DIGIS, 1);
       // Dump raw digi info.
       if (infoV > 1) {
 	std::ostringstream strstrm;
@@ -856,9 +1042,15 @@ void CSCCathodeLCTProcessor::readComparatorDigis(
 	continue;
       }
 
-      // Get bx times on this digi and check that they are within the bounds.
-      std::vector<int> bx_times = pld->getTimeBinsOn();
-      for (unsigned int i = 0; i < bx_times.size(); i++) {
+      // Get bx times on this digi, decoded from its time-bin word, and
+      // check that they are within the bounds.
+      const unsigned int tbin_word = pld->getTimeBinWord();
+      int bx_times[8*sizeof(tbin_word)];
+      unsigned int n_bins = 0;
+      for (unsigned int tbin = 0; tbin < 8*sizeof(tbin_word); tbin++) {
+	if ((tbin_word >> tbin) & 1) bx_times[n_bins++] = tbin;
+      }
+      for (unsigned int i = 0; i < n_bins; i++) {
 	// Total number of time bins in DAQ readout is given by fifo_tbins,
 	// which thus determines the maximum length of time interval.
 	//
@@ -921,10 +1113,10 @@ void CSCCathodeLCTProcessor::readComparatorDigis(
   }
 
   for (int i = 0; i < CSCConstants::NUM_LAYERS; i++) {
-    std::vector <CSCComparatorDigi> layerDigiV = digiV[i];
+    const std::vector <CSCComparatorDigi>& layerDigiV = digiV[i];
     for (unsigned int j = 0; j < layerDigiV.size(); j++) {
       // Get one digi at a time for the layer.  -Jm
-      CSCComparatorDigi thisDigi = layerDigiV[j];
+      const CSCComparatorDigi& thisDigi = layerDigiV[j];
 
       // Dump raw digi info
       if (infoV > 1) LogTrace("CSCCathodeLCTProcessor")
@@ -1016,7 +1208,7 @@ void CSCCathodeLCTProcessor::readComparatorDigis(
       // This loop is only for distrips.  We have to separate the routines
       // because triad and time arrays can be changed by the distripStagger
       // routine which could mess up the halfstrips.
-      static int test_iteration = 0;
+      int test_iteration = 0;
       for (int j = 0; j < CSCConstants::MAX_NUM_STRIPS; j++){
 	if (time[i][j] >= 0) {
 	  int i_distrip = j/2;
@@ -1235,8 +1427,8 @@ bool CSCCathodeLCTProcessor::preTrigger(const std::vector<int> strip[CSCConstant
 					const int stripType, const int nStrips,
 					int& first_bx)
 {
-  static const int hs_thresh = nplanes_hit_pretrig;
-  static const int ds_thresh = nplanes_hit_pretrig;
+  const int hs_thresh = nplanes_hit_pretrig;
+  const int ds_thresh = nplanes_hit_pretrig;
 
   unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
   int i_layer, i_strip, this_layer, this_strip;
@@ -1320,7 +1512,7 @@ void CSCCathodeLCTProcessor::getKeyStripData(const std::vector<int> strip[CSCCon
       if ((this_strip >= 0 && this_strip < nStrips) &&
 	  !strip[this_layer][this_strip].empty()) {
 	if (nullPattern) nullPattern = false;
-	std::vector<int> bx_times = strip[this_layer][this_strip];
+	const std::vector<int>& bx_times = strip[this_layer][this_strip];
 	lct_pattern[pattern_strip] = bx_times[0];
       }
       else
@@ -1590,8 +1782,8 @@ bool CSCCathodeLCTProcessor::preTrigLookUp(
 	   const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
 	   const int stripType, const int nStrips,
 	   const unsigned int bx_time) {
-  static const int hs_thresh = nplanes_hit_pretrig;
-  static const int ds_thresh = nplanes_hit_pretrig;
+  const int hs_thresh = nplanes_hit_pretrig;
+  const int ds_thresh = nplanes_hit_pretrig;
 
   bool hit_layer[CSCConstants::NUM_LAYERS];
   int key_strip, this_layer, this_strip, layers_hit;
@@ -1714,7 +1906,7 @@ void CSCCathodeLCTProcessor::priorityEncode(
         const int h_keyStrip[MAX_CFEBS], const unsigned int h_nhits[MAX_CFEBS],
 	const int d_keyStrip[MAX_CFEBS], const unsigned int d_nhits[MAX_CFEBS],
 	int keystrip_data[2][7]) {
-  static const unsigned int hs_thresh = nplanes_hit_pretrig;
+  const unsigned int hs_thresh = nplanes_hit_pretrig;
   //static const unsigned int ds_thresh = nplanes_hit_pretrig;
 
   int ihits[2]; // hold hits for sorting
@@ -2067,6 +2259,7 @@ std::vector<CSCCLCTDigi> CSCCathodeLCTProcessor::findLCTs(const std::vector<int>
     // will pre-trigger.
     if (pre_trig) {
       thePreTriggerBXs.push_back(first_bx);
+      if (trace) tracePreTriggers(first_bx, maxHalfStrips);
       if (infoV > 1) LogTrace("CSCCathodeLCTProcessor")
 	<< "..... pretrigger at bx = " << first_bx
 	<< "; waiting drift delay .....";
@@ -2147,6 +2340,10 @@ std::vector<CSCCLCTDigi> CSCCathodeLCTProcessor::findLCTs(const std::vector<int>
 	bool ptn_trig = false;
 	for (int ilct = 0; ilct < max_lcts; ilct++) {
 	  int best_hs = best_halfstrip[ilct];
+	  if (trace && best_hs >= 0)
+	    trace->record(traceId, CSCTriggerTrace::CLCT,
+			  CSCTriggerTrace::PATTERN_HIT, latch_bx, best_hs,
+			  best_pid[best_hs], nhits[best_hs]);
 	  if (best_hs >= 0 && nhits[best_hs] >= nplanes_hit_pattern) {
 	    ptn_trig = true;
 	    keystrip_data[ilct][CLCT_PATTERN]    = best_pid[best_hs];
@@ -2178,6 +2375,9 @@ std::vector<CSCCLCTDigi> CSCCathodeLCTProcessor::findLCTs(const std::vector<int>
 				keystrip_data[ilct][CLCT_CFEB],
 				keystrip_data[ilct][CLCT_BX]);
 	    lctList.push_back(thisLCT);
+	    if (trace) trace->record(traceId, CSCTriggerTrace::CLCT,
+				     CSCTriggerTrace::LATCH, first_bx, best_hs,
+				     best_pid[best_hs], nhits[best_hs]);
 	  }
 	}
 
@@ -2192,19 +2392,16 @@ std::vector<CSCCLCTDigi> CSCCathodeLCTProcessor::findLCTs(const std::vector<int>
 	  // at later bx's we won't have a full set of hits for a
 	  // pattern search anyway.
 	  unsigned int stop_time = fifo_tbins - drift_delay;
+	  PatternCounts counts;
+	  initPatternCounts(pulse, maxHalfStrips, latch_bx, counts);
 	  for (unsigned int bx = latch_bx + 1; bx < stop_time; bx++) {
 	    bool return_to_idle = true;
-	    bool hits_in_time = ptnFinding(pulse, maxHalfStrips, bx);
-	    if (hits_in_time) {
-	      for (int hstrip = stagger[CSCConstants::KEY_CLCT_LAYER-1];
-		   hstrip < maxHalfStrips; hstrip++) {
-		if (nhits[hstrip] >= nplanes_hit_pattern) {
-		  if (infoV > 1) LogTrace("CSCCathodeLCTProcessor")
-		    << " State machine busy at bx = " << bx;
-		  return_to_idle = false;
-		  break;
-		}
-	      }
+	    updatePatternCounts(pulse, maxHalfStrips, bx, counts);
+	    if (hitsInTime(counts) && counts.n_busy > 0) {
+	      if (infoV > 1) LogTrace("CSCCathodeLCTProcessor")
+		<< " State machine busy at bx = " << bx;
+	      CSCTP_COUNT(theStation, theRing, DEAD_TIME_BX, 1);
+	      return_to_idle = false;
 	    }
 	    if (return_to_idle) {
 	      if (infoV > 1) LogTrace("CSCCathodeLCTProcessor")
@@ -2231,7 +2428,8 @@ void CSCCathodeLCTProcessor::pulseExtension(
  const int nStrips,
  unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS]) {
 
-  static unsigned int bits_in_pulse = 8*sizeof(pulse[0][0]);
+  CSCTP_TIME(theStation, theRing, PULSE_EXTENSION);
+  const unsigned int bits_in_pulse = 8*sizeof(pulse[0][0]);
 
   // Clear pulse array.  This array will be used as a bit representation of
   // hit times.  For example: if strip[1][2] has a value of 3, then 1 shifted
@@ -2251,7 +2449,7 @@ void CSCCathodeLCTProcessor::pulseExtension(
       // If there is a hit, simulate digital one-shot persistence starting
       // in the bx of the initial hit.  Fill this into pulse[][].
       if (time[i_layer][i_strip].size() > 0) {
-	std::vector<int> bx_times = time[i_layer][i_strip];
+	const std::vector<int>& bx_times = time[i_layer][i_strip];
 	for (unsigned int i = 0; i < bx_times.size(); i++) {
 	  // Check that min and max times are within the allowed range.
 	  if (bx_times[i] < 0 || bx_times[i] + hit_persist >= bits_in_pulse) {
@@ -2263,6 +2461,7 @@ void CSCCathodeLCTProcessor::pulseExtension(
 	    continue;
 	  }
 	  if (bx_times[i] >= start_bx_shift) {
+	    CSCTP_COUNT(theStation, theRing, PULSES, 1);
 	    for (unsigned int bx = bx_times[i]; bx < bx_times[i] + hit_persist; ++bx)
               pulse[i_layer][i_strip] = pulse[i_layer][i_strip] | (1 << bx);
           }
@@ -2277,6 +2476,7 @@ void CSCCathodeLCTProcessor::pulseExtension(
 bool CSCCathodeLCTProcessor::preTrigger(
   const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
 					const int start_bx, int& first_bx) {
+  CSCTP_TIME(theStation, theRing, PRE_TRIGGER);
   if (infoV > 1) LogTrace("CSCCathodeLCTProcessor")
     << "....................PreTrigger...........................";
 
@@ -2313,6 +2513,7 @@ bool CSCCathodeLCTProcessor::preTrigger(
       }
 
       if (pre_trig) {
+	CSCTP_COUNT(theStation, theRing, PRETRIGGERS, 1);
 	first_bx = bx_time; // bx at time of pretrigger
 	return true;
       }
@@ -2333,6 +2534,21 @@ bool CSCCathodeLCTProcessor::ptnFinding(
 {
   if (bx_time >= fifo_tbins) return false;
 
+  CSCTP_TIME(theStation, theRing, PATTERN_DETECTION);
+  CSCTP_COUNT(theStation, theRing, PATTERN_SEARCHES, 1);
+  return (this->*ptn_finding_kernel)(pulse, nStrips, bx_time);
+} // ptnFinding -- TMB-07 version.
+
+
+// TMB-07 version, one key half-strip at a time.
+template <bool CorrectedBx>
+bool CSCCathodeLCTProcessor::ptnFindingScalar(
+	   const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+	   const int nStrips, const unsigned int bx_time)
+{
+  // CorrectedBx tells whether the median start time of the pattern hits
+  // is needed, see selectAlgorithm().
+
   // This loop is a quick check of a number of layers hit at bx_time: since
   // most of the time it is 0, this check helps to speed-up the execution
   // substantially.
@@ -2354,59 +2570,52 @@ bool CSCCathodeLCTProcessor::ptnFinding(
   {
     best_pid[key_hstrip] = 0;
     nhits[key_hstrip] = 0;
-    first_bx_corrected[key_hstrip] = -999;
+    if (CorrectedBx) first_bx_corrected[key_hstrip] = -999;
   }
 
   // Loop over candidate key strips.
-  bool hit_layer[CSCConstants::NUM_LAYERS];
+  bool hit_layer;
   for (int key_hstrip = stagger[CSCConstants::KEY_CLCT_LAYER - 1]; key_hstrip < nStrips; key_hstrip++)
   {
     // Loop over patterns and look for hits matching each pattern.
     for (unsigned int pid = CSCConstants::NUM_CLCT_PATTERNS - 1; pid >= pid_thresh_pretrig; pid--)
     {
       layers_hit = 0;
-      for (int ilayer = 0; ilayer < CSCConstants::NUM_LAYERS; ilayer++)
-	hit_layer[ilayer] = false;
+      const int* layer_begin = pattern_cells->layer_begin[pid];
+      const int* offset = pattern_cells->offset[pid];
 
       double num_pattern_hits=0., times_sum=0.;
-      std::multiset<int> mset_for_median;
-      mset_for_median.clear();
+      int times_for_median[NUM_PATTERN_HALFSTRIPS];
+      int n_times = 0;
 
-      // Loop over halfstrips in trigger pattern mask and calculate the
-      // "absolute" halfstrip number for each.
-      for (int strip_num = 0; strip_num < NUM_PATTERN_HALFSTRIPS; strip_num++)
+      // Loop over halfstrips in trigger pattern mask, layer by layer, and
+      // calculate the "absolute" halfstrip number for each.
+      for (int this_layer = 0; this_layer < CSCConstants::NUM_LAYERS; this_layer++)
       {
-	int this_layer = pattern2007[pid][strip_num];
-        if (this_layer >= 0 && this_layer < CSCConstants::NUM_LAYERS)
+	hit_layer = false;
+	for (int i_cell = layer_begin[this_layer]; i_cell < layer_begin[this_layer+1]; i_cell++)
         {
-	  int this_strip = pattern2007_offset[strip_num] + key_hstrip;
+	  int this_strip = offset[i_cell] + key_hstrip;
 	  if (this_strip >= 0 && this_strip < nStrips) {
 	    if (infoV > 3) LogTrace("CSCCathodeLCTProcessor")
 	      << " In ptnFinding: key_strip = " << key_hstrip
-	      << " pid = " << pid << " strip_num = " << strip_num
+	      << " pid = " << pid
 	      << " layer = " << this_layer << " strip = " << this_strip;
 	    // Determine if "one shot" is high at this bx_time
             if (((pulse[this_layer][this_strip] >> bx_time) & 1) == 1)
             {
-              if (hit_layer[this_layer] == false)
+              if (hit_layer == false)
               {
-		hit_layer[this_layer] = true;
+		hit_layer = true;
 		layers_hit++;     // determines number of layers hit
 	      }
+	      if (!CorrectedBx) continue;
 
               // find at what bx did pulse on this halsfstrip&layer have started
-              // use hit_pesrist constraint on how far back we can go
-              int first_bx_layer = bx_time;
-              for (unsigned int dbx = 0; dbx < hit_persist; dbx++)
-              {
-                if (((pulse[this_layer][this_strip] >> (first_bx_layer - 1)) & 1) == 1)
-                  first_bx_layer--;
-                else
-                  break;
-              }
+              int first_bx_layer = pulseStartBx(pulse, this_layer, this_strip, bx_time);
               times_sum += (double) first_bx_layer;
               num_pattern_hits += 1.;
-              mset_for_median.insert(first_bx_layer);
+              times_for_median[n_times++] = first_bx_layer;
               if (infoV > 2)
                 LogTrace("CSCCathodeLCTProcessor") << " 1st bx in layer: " << first_bx_layer << " sum bx: " << times_sum
                     << " #pat. hits: " << num_pattern_hits;
@@ -2421,22 +2630,8 @@ bool CSCCathodeLCTProcessor::ptnFinding(
 	nhits[key_hstrip] = layers_hit;
 
         // calculate median
-        const int sz = mset_for_median.size();
-        if (sz>0){
-          std::multiset<int>::iterator im = mset_for_median.begin();
-          if (sz>1) std::advance(im,sz/2-1);
-          if (sz==1) first_bx_corrected[key_hstrip] = *im;
-          else if ((sz % 2) == 1) first_bx_corrected[key_hstrip] = *(++im);
-          else first_bx_corrected[key_hstrip] = ((*im) + (*(++im)))/2;
-
-          if (infoV > 1) {
-            char bxs[300]="";
-            for (im = mset_for_median.begin(); im != mset_for_median.end(); im++)
-              sprintf(bxs,"%s %d", bxs, *im);
-            LogTrace("CSCCathodeLCTProcessor")
-              <<"bx="<<bx_time<<" bx_cor="<< first_bx_corrected[key_hstrip]<<"  bxset="<<bxs;
-          }
-        }
+        if (CorrectedBx)
+          setFirstBxCorrected(key_hstrip, bx_time, times_for_median, n_times);
 
 	// Do not loop over the other (worse) patterns if max. numbers of
 	// hits is found.
@@ -2445,7 +2640,254 @@ bool CSCCathodeLCTProcessor::ptnFinding(
     } // end loop over pid
   } // end loop over candidate key strips
   return true;
-} // ptnFinding -- TMB-07 version.
+} // ptnFindingScalar -- TMB-07 version.
+
+
+// TMB-07 version, bit-parallel.
+template <bool CorrectedBx>
+bool CSCCathodeLCTProcessor::ptnFindingBitParallel(
+	   const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+	   const int nStrips, const unsigned int bx_time)
+{
+  // Same results as ptnFindingScalar(), but the layers hit in a pattern are
+  // counted for all key half-strips at once.  Each layer at bx_time is
+  // turned into a half-strip bitset; for every pattern, the bitsets shifted
+  // by the offsets of the pattern cells are ORed per layer, and the layers
+  // are summed into a 3-bit counter kept as three bitsets.  Bit k refers to
+  // key half-strip k.
+  HalfStripBits hits[CSCConstants::NUM_LAYERS];
+  unsigned int layers_hit = 0;
+  for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
+  {
+    for (int i_hstrip = 0; i_hstrip < nStrips; i_hstrip++)
+    {
+      if (((pulse[i_layer][i_hstrip] >> bx_time) & 1) == 1)
+	hits[i_layer].set(i_hstrip);
+    }
+    if (hits[i_layer].any()) layers_hit++;
+  }
+  if (layers_hit < nplanes_hit_pretrig) return false;
+
+  for (int key_hstrip = 0; key_hstrip < nStrips; key_hstrip++)
+  {
+    best_pid[key_hstrip] = 0;
+    nhits[key_hstrip] = 0;
+    if (CorrectedBx) first_bx_corrected[key_hstrip] = -999;
+  }
+
+  HalfStripBits count[3], layer_bits, carry;
+  for (unsigned int pid = CSCConstants::NUM_CLCT_PATTERNS - 1; pid >= pid_thresh_pretrig; pid--)
+  {
+    count[0].reset();
+    count[1].reset();
+    count[2].reset();
+    const int* layer_begin = pattern_cells->layer_begin[pid];
+    const int* offset = pattern_cells->offset[pid];
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
+    {
+      layer_bits.reset();
+      for (int i_cell = layer_begin[i_layer]; i_cell < layer_begin[i_layer+1]; i_cell++)
+      {
+	if (offset[i_cell] >= 0) layer_bits |= hits[i_layer] >> offset[i_cell];
+	else                     layer_bits |= hits[i_layer] << -offset[i_cell];
+      }
+      // Add one layer to the counter.
+      carry     = count[0] & layer_bits;
+      count[0] ^= layer_bits;
+      layer_bits = count[1] & carry;
+      count[1] ^= carry;
+      count[2] |= layer_bits;
+    }
+
+    // Patterns are tried from the best to the worst one, and a worse
+    // pattern is only taken if it has more layers hit.
+    const HalfStripBits any_hits = count[0] | count[1] | count[2];
+    for (int key_hstrip = stagger[CSCConstants::KEY_CLCT_LAYER - 1]; key_hstrip < nStrips; key_hstrip++)
+    {
+      if (!any_hits.test(key_hstrip)) continue;
+      layers_hit = (count[0].test(key_hstrip) ? 1 : 0) +
+	           (count[1].test(key_hstrip) ? 2 : 0) +
+	           (count[2].test(key_hstrip) ? 4 : 0);
+      if (layers_hit > nhits[key_hstrip])
+      {
+	best_pid[key_hstrip] = pid;
+	nhits[key_hstrip] = layers_hit;
+	if (!CorrectedBx) continue;
+
+	// Hit times for the median are only needed for the best pattern.
+	int times_for_median[NUM_PATTERN_HALFSTRIPS];
+	int n_times = 0;
+	for (int this_layer = 0; this_layer < CSCConstants::NUM_LAYERS; this_layer++)
+	{
+	  for (int i_cell = layer_begin[this_layer]; i_cell < layer_begin[this_layer+1]; i_cell++)
+	  {
+	    int this_strip = offset[i_cell] + key_hstrip;
+	    if (this_strip >= 0 && this_strip < nStrips &&
+		((pulse[this_layer][this_strip] >> bx_time) & 1) == 1)
+	      times_for_median[n_times++] =
+		pulseStartBx(pulse, this_layer, this_strip, bx_time);
+	  }
+	}
+	setFirstBxCorrected(key_hstrip, bx_time, times_for_median, n_times);
+      }
+    }
+  }
+  return true;
+} // ptnFindingBitParallel -- TMB-07 version.
+
+
+int CSCCathodeLCTProcessor::pulseStartBx(
+	   const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+	   const int layer, const int hstrip, const unsigned int bx_time) const
+{
+  // Find at what bx did the pulse on this halfstrip & layer, still on at
+  // bx_time, start; use hit_persist constraint on how far back we can go.
+  int first_bx_layer = bx_time;
+  for (unsigned int dbx = 0; dbx < hit_persist; dbx++)
+  {
+    if (((pulse[layer][hstrip] >> (first_bx_layer - 1)) & 1) == 1)
+      first_bx_layer--;
+    else
+      break;
+  }
+  return first_bx_layer;
+}
+
+
+void CSCCathodeLCTProcessor::setFirstBxCorrected(const int key_hstrip,
+						 const unsigned int bx_time,
+						 int* hit_times, const int n_times)
+{
+  // The corrected bx of a key half-strip is the median of the start times
+  // of the hits in its best pattern.  The hit times are reordered in place.
+  if (n_times>0){
+    first_bx_corrected[key_hstrip] = cscMedianBx(hit_times, n_times);
+
+    if (infoV > 1) {
+      std::sort(hit_times, hit_times + n_times);
+      std::ostringstream bxs;
+      for (int i = 0; i < n_times; i++) bxs << " " << hit_times[i];
+      LogTrace("CSCCathodeLCTProcessor")
+        <<"bx="<<bx_time<<" bx_cor="<< first_bx_corrected[key_hstrip]<<"  bxset="<<bxs.str();
+    }
+  }
+}
+
+
+// TMB-07 version.
+void CSCCathodeLCTProcessor::initPatternCounts(
+	   const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+	   const int nStrips, const unsigned int bx_time,
+	   PatternCounts& counts) const
+{
+  // Counts of the layers hit at bx_time, from scratch.
+  memset(counts.cells, 0, sizeof(counts.cells));
+  memset(counts.layers, 0, sizeof(counts.layers));
+  counts.n_busy = 0;
+  if (nplanes_hit_pattern == 0) {
+    // Every evaluated (key, pattern id) pair is at threshold.
+    const int first_key = stagger[CSCConstants::KEY_CLCT_LAYER - 1];
+    if (nStrips > first_key && CSCConstants::NUM_CLCT_PATTERNS > pid_thresh_pretrig)
+      counts.n_busy = (nStrips - first_key) *
+	(CSCConstants::NUM_CLCT_PATTERNS - pid_thresh_pretrig);
+  }
+
+  for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
+  {
+    counts.strips_on[i_layer] = 0;
+    for (int i_hstrip = 0; i_hstrip < nStrips; i_hstrip++)
+    {
+      if (((pulse[i_layer][i_hstrip] >> bx_time) & 1) == 1)
+      {
+	counts.strips_on[i_layer]++;
+	addPatternHit(i_layer, i_hstrip, nStrips, 1, counts);
+      }
+    }
+  }
+} // initPatternCounts -- TMB-07 version.
+
+
+// TMB-07 version.
+void CSCCathodeLCTProcessor::updatePatternCounts(
+	   const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+	   const int nStrips, const unsigned int bx_time,
+	   PatternCounts& counts) const
+{
+  // Move the counts from bx_time-1 to bx_time: only the one-shots which
+  // fire or expire at bx_time change them.
+  for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
+  {
+    for (int i_hstrip = 0; i_hstrip < nStrips; i_hstrip++)
+    {
+      const unsigned int edge =
+	((pulse[i_layer][i_hstrip] >> (bx_time - 1)) ^
+	 (pulse[i_layer][i_hstrip] >> bx_time)) & 1;
+      if (edge == 0) continue;
+      const int delta = ((pulse[i_layer][i_hstrip] >> bx_time) & 1) ? 1 : -1;
+      counts.strips_on[i_layer] += delta;
+      addPatternHit(i_layer, i_hstrip, nStrips, delta, counts);
+    }
+  }
+} // updatePatternCounts -- TMB-07 version.
+
+
+// TMB-07 version.
+void CSCCathodeLCTProcessor::addPatternHit(const int layer, const int hstrip,
+					   const int nStrips, const int delta,
+					   PatternCounts& counts) const
+{
+  // Add (delta = 1) or remove (delta = -1) a hit to the patterns of all key
+  // half-strips it lies on.
+  const int first_key = stagger[CSCConstants::KEY_CLCT_LAYER - 1];
+  for (unsigned int pid = CSCConstants::NUM_CLCT_PATTERNS - 1; pid >= pid_thresh_pretrig; pid--)
+  {
+    const int* offset = pattern_cells->offset[pid];
+    for (int i_cell = pattern_cells->layer_begin[pid][layer]; i_cell < pattern_cells->layer_begin[pid][layer+1]; i_cell++)
+    {
+      const int key_hstrip = hstrip - offset[i_cell];
+      if (key_hstrip < first_key || key_hstrip >= nStrips) continue;
+
+      unsigned char& cells = counts.cells[key_hstrip][pid][layer];
+      unsigned char& layers = counts.layers[key_hstrip][pid];
+      if (delta > 0 && cells++ == 0)
+      {
+	// layer becomes hit
+	if (++layers == nplanes_hit_pattern) counts.n_busy++;
+      }
+      else if (delta < 0 && --cells == 0)
+      {
+	// layer is no longer hit
+	if (layers-- == nplanes_hit_pattern) counts.n_busy--;
+      }
+    }
+  }
+} // addPatternHit -- TMB-07 version.
+
+
+bool CSCCathodeLCTProcessor::hitsInTime(const PatternCounts& counts) const
+{
+  // Same as the quick check on the number of layers hit in ptnFinding().
+  unsigned int layers_hit = 0;
+  for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
+    if (counts.strips_on[i_layer] > 0) layers_hit++;
+  return (layers_hit >= nplanes_hit_pretrig);
+}
+
+
+unsigned int CSCCathodeLCTProcessor::patternNhits(const PatternCounts& counts,
+						  const int key_hstrip) const
+{
+  // Same as nhits[key_hstrip] found by ptnFinding().
+  unsigned int layers_hit = 0;
+  if (key_hstrip < 0 || key_hstrip >= CSCConstants::NUM_HALF_STRIPS)
+    return layers_hit;
+  for (unsigned int pid = CSCConstants::NUM_CLCT_PATTERNS - 1; pid >= pid_thresh_pretrig; pid--)
+  {
+    if (counts.layers[key_hstrip][pid] > layers_hit)
+      layers_hit = counts.layers[key_hstrip][pid];
+  }
+  return layers_hit;
+}
 
 
 // TMB-07 version.
@@ -2467,6 +2909,18 @@ void CSCCathodeLCTProcessor::markBusyKeys(const int best_hstrip,
 } // markBusyKeys -- TMB-07 version.
 
 
+// TMB-07 version.
+void CSCCathodeLCTProcessor::tracePreTriggers(const int bx, const int nStrips)
+{
+  for (int hstrip = stagger[CSCConstants::KEY_CLCT_LAYER-1];
+       hstrip < nStrips; hstrip++) {
+    if (ispretrig[hstrip])
+      trace->record(traceId, CSCTriggerTrace::CLCT, CSCTriggerTrace::PRETRIGGER,
+		    bx, hstrip, best_pid[hstrip], nhits[hstrip]);
+  }
+} // tracePreTriggers -- TMB-07 version.
+
+
 
 // --------------------------------------------------------------------------
 // The code below is for SLHC studies of the CLCT algorithm (half-strips only).
@@ -2516,6 +2970,7 @@ CSCCathodeLCTProcessor::findLCTsSLHC(const std::vector<int> halfstrip[CSCConstan
     // will pre-trigger.
     if (pre_trig)
     {
+      if (trace) tracePreTriggers(first_bx, maxHalfStrips);
       if (infoV > 1)
         LogTrace("CSCCathodeLCTProcessor") << "..... pretrigger at bx = " << first_bx << "; waiting drift delay .....";
 
@@ -2630,6 +3085,9 @@ CSCCathodeLCTProcessor::findLCTsSLHC(const std::vector<int> halfstrip[CSCConstan
         for (int ilct = 0; ilct < max_lcts; ilct++)
         {
           int best_hs = best_halfstrip[ilct];
+          if (trace && best_hs >= 0)
+            trace->record(traceId, CSCTriggerTrace::CLCT, CSCTriggerTrace::PATTERN_HIT,
+                latch_bx, best_hs, best_pid[best_hs], nhits[best_hs]);
           if (best_hs >= 0 && nhits[best_hs] >= nplanes_hit_pattern)
           {
             int bx  = first_bx;
@@ -2660,6 +3118,9 @@ CSCCathodeLCTProcessor::findLCTsSLHC(const std::vector<int> halfstrip[CSCConstan
             thisLCT.setFullBX(fbx);
             lctList.push_back(thisLCT);
             lctListBX.push_back(thisLCT);
+            if (trace)
+              trace->record(traceId, CSCTriggerTrace::CLCT, CSCTriggerTrace::LATCH,
+                  bx, best_hs, best_pid[best_hs], nhits[best_hs]);
           }
         }
 
@@ -2672,6 +3133,7 @@ CSCCathodeLCTProcessor::findLCTsSLHC(const std::vector<int> halfstrip[CSCConstan
           // [clct_key-clct_state_machine_zone, clct_key+clct_state_machine_zone]
           // starting from first_bx+1.
           // The search for CLCTs resumes only when the number of hits on key halfstrip drops below threshold.
+          PatternCounts counts;
           for (unsigned int ilct = 0; ilct < lctListBX.size(); ilct++)
           {
             int key_hstrip = lctListBX[ilct].getKeyStrip() + stagger[CSCConstants::KEY_CLCT_LAYER - 1];
@@ -2697,6 +3159,7 @@ CSCCathodeLCTProcessor::findLCTsSLHC(const std::vector<int> halfstrip[CSCConstan
             // pattern search anyway.
             //int stop_time = fifo_tbins - drift_delay;
             // -- no, need to extend busyMap over fifo_tbins - drift_delay
+            initPatternCounts(pulse, maxHalfStrips, latch_bx, counts);
             for (size_t bx = first_bx + 1; bx < fifo_tbins; bx++)
             {
               bool busy_bx = false;
@@ -2704,18 +3167,23 @@ CSCCathodeLCTProcessor::findLCTsSLHC(const std::vector<int> halfstrip[CSCConstan
                 busy_bx = true; // always busy before drift time
               if (!busy_bx)
               {
-                bool hits_in_time = ptnFinding(pulse, maxHalfStrips, bx);
-                if (hits_in_time && nhits[key_hstrip] >= nplanes_hit_pattern)
+                updatePatternCounts(pulse, maxHalfStrips, bx, counts);
+                bool hits_in_time = hitsInTime(counts);
+                unsigned int key_nhits = patternNhits(counts, key_hstrip);
+                if (hits_in_time && key_nhits >= nplanes_hit_pattern)
                   busy_bx = true;
                 if (infoV > 2)
                   LogTrace("CSCCathodeLCTProcessor") << "  at bx=" << bx << " hits_in_time=" << hits_in_time << " nhits="
-                      << nhits[key_hstrip];
+                      << key_nhits;
               }
               if (infoV > 2)
                 LogTrace("CSCCathodeLCTProcessor") << "  at bx=" << bx << " busy=" << busy_bx;
               if (busy_bx)
+              {
+                CSCTP_COUNT(theStation, theRing, DEAD_TIME_BX, 1);
                 for (int hstrip = min_hstrip; hstrip <= max_hstrip; hstrip++)
                   busyMap[hstrip][bx] = true;
+              }
               else
                 break;
             }
@@ -2790,7 +3258,7 @@ void CSCCathodeLCTProcessor::dumpDigis(const std::vector<int> strip[CSCConstants
     strstrm << "\n";
     for (int i_strip = 0; i_strip < nStrips; i_strip++) {
       if (!strip[i_layer][i_strip].empty()) {
-	std::vector<int> bx_times = strip[i_layer][i_strip];
+	const std::vector<int>& bx_times = strip[i_layer][i_strip];
 	// Dump only the first in time.
 	strstrm << std::hex << bx_times[0] << std::dec;
       }
@@ -2803,11 +3271,17 @@ void CSCCathodeLCTProcessor::dumpDigis(const std::vector<int> strip[CSCConstants
   LogTrace("CSCCathodeLCTProcessor") << strstrm.str();
 }
 
-// Returns vector of read-out CLCTs, if any.  Starts with the vector
-// of all found CLCTs and selects the ones in the read-out time window.
+// Returns vector of read-out CLCTs, if any.
 std::vector<CSCCLCTDigi> CSCCathodeLCTProcessor::readoutCLCTs() {
   std::vector<CSCCLCTDigi> tmpV;
+  readoutCLCTs(tmpV);
+  return tmpV;
+}
 
+// Appends read-out CLCTs, if any, to the given vector.  Goes over all
+// found CLCTs, in the order of getCLCTs(), and selects the ones in the
+// read-out time window.
+void CSCCathodeLCTProcessor::readoutCLCTs(std::vector<CSCCLCTDigi>& clcts) {
   // The start time of the L1A*CLCT coincidence window should be
   // related to the fifo_pretrig parameter, but I am not completely
   // sure how.  For now, just choose it such that the window is
@@ -2821,34 +3295,34 @@ std::vector<CSCCLCTDigi> CSCCathodeLCTProcessor::readoutCLCTs() {
   // tmb_l1a_window_size parameter, but made even by setting the LSB
   // of tmb_l1a_window_size to 0.
   //
-  static int lct_bins   = 
+  int lct_bins   = 
     (tmb_l1a_window_size%2 == 0) ? tmb_l1a_window_size : tmb_l1a_window_size-1;
-  static int late_tbins = early_tbins + lct_bins;
+  int late_tbins = early_tbins + lct_bins;
+
+  if (late_tbins > MAX_CLCT_BINS-1) late_tbins = MAX_CLCT_BINS-1;
 
-  static int ifois = 0;
-  if (ifois == 0) {
+  static std::atomic<bool> readout_checked(false);
+  if (!readout_checked.exchange(true)) {
     if (infoV >= 0 && early_tbins < 0) {
       edm::LogWarning("L1CSCTPEmulatorSuspiciousParameters")
 	<< "+++ early_tbins = " << early_tbins
 	<< "; in-time CLCTs are not getting read-out!!! +++" << "\n";
     }
 
-    if (late_tbins > MAX_CLCT_BINS-1) {
+    if (early_tbins + lct_bins > MAX_CLCT_BINS-1) {
       if (infoV >= 0) edm::LogWarning("L1CSCTPEmulatorSuspiciousParameters")
-	<< "+++ Allowed range of time bins, [0-" << late_tbins
+	<< "+++ Allowed range of time bins, [0-" << early_tbins + lct_bins
 	<< "] exceeds max allowed, " << MAX_CLCT_BINS-1 << " +++\n"
 	<< "+++ Set late_tbins to max allowed +++\n";
-      late_tbins = MAX_CLCT_BINS-1;
     }
-    ifois = 1;
   }
 
-  // Start from the vector of all found CLCTs and select those within
-  // the CLCT*L1A coincidence window.
+  // Go over all found CLCTs and select those within the CLCT*L1A
+  // coincidence window.
   int bx_readout = -1;
-  std::vector<CSCCLCTDigi> all_lcts = getCLCTs();
-  for (std::vector <CSCCLCTDigi>::const_iterator plct = all_lcts.begin();
-       plct != all_lcts.end(); plct++) {
+  for (int i_lct = 0; i_lct < 2*MAX_CLCT_BINS; i_lct++) {
+    const CSCCLCTDigi* plct =
+      (i_lct%2 == 0) ? &bestCLCT[i_lct/2] : &secondCLCT[i_lct/2];
     if (!plct->isValid()) continue;
 
     int bx = (*plct).getBX();
@@ -2875,13 +3349,12 @@ std::vector<CSCCLCTDigi> CSCCathodeLCTProcessor::readoutCLCTs() {
     // currently there is room just for two.
     if (readout_earliest_2) {
       if (bx_readout == -1 || bx == bx_readout) {
-        tmpV.push_back(*plct);
+        clcts.push_back(*plct);
         if (bx_readout == -1) bx_readout = bx;
       }
     }
-    else tmpV.push_back(*plct);
+    else clcts.push_back(*plct);
   }
-  return tmpV;
 }
 
 // Returns vector of all found CLCTs, if any.  Used for ALCT-CLCT matching.
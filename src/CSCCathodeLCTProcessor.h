@@ -28,11 +28,15 @@
  */
 
 #include <vector>
+#include <bitset>
 #include <FWCore/ParameterSet/interface/ParameterSet.h>
 #include <DataFormats/CSCDigi/interface/CSCComparatorDigiCollection.h>
 #include <DataFormats/CSCDigi/interface/CSCCLCTDigi.h>
 #include <CondFormats/CSCObjects/interface/CSCDBL1TPParameters.h>
 #include <L1Trigger/CSCCommonTrigger/interface/CSCConstants.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCChamberGeometryInfo.h>
+
+class CSCTriggerTrace;
 
 class CSCCathodeLCTProcessor
 {
@@ -50,6 +54,25 @@ class CSCCathodeLCTProcessor
   /** Sets configuration parameters obtained via EventSetup mechanism. */
   void setConfigParameters(const CSCDBL1TPParameters* conf);
 
+  /** Sets the number of strips and the staggering of layers from a
+      snapshot of the chamber geometry; done when the geometry changes.
+      Without it, the processor built by the normal constructor does not
+      run.  The ring must be set beforehand. */
+  void setChamberGeometry(const CSCChamberGeometryInfo& info);
+
+  /** Sets the verbosity level (see infoV); used in standalone tests. */
+  void setVerbosity(const int verbosity);
+
+  /** Sets the upgrade and ME1/1 flags of the common parameters, for the
+      processors of the upgrade ME1/1 TMB built by its test constructor.
+      The ring must be set beforehand. */
+  void setME11Flags(const bool slhc, const bool smart,
+		    const bool disable_me1a, const bool ganged_me1a);
+
+  /** Records the decisions of this processor into the given trace; 0
+      turns tracing off.  The ring must be set beforehand. */
+  void setTrace(CSCTriggerTrace* trace);
+
   /** Clears the LCT containers. */
   void clear();
 
@@ -66,6 +89,15 @@ class CSCCathodeLCTProcessor
   bool getDigis(const CSCComparatorDigiCollection* compdc);
   void getDigis(const CSCComparatorDigiCollection* compdc, const CSCDetId& id);
 
+  /** Fills the half-strip (and di-strip) times from the given comparator
+      digis of each layer, as run(compdc) does; lets standalone programs
+      pass the digis of a chamber to run(halfstrip, distrip) without a
+      digi collection.  ME1/a strips must already be numbered as this
+      processor reads them. */
+  void readComparatorDigis(const std::vector<CSCComparatorDigi> digis[CSCConstants::NUM_LAYERS],
+			   std::vector<int> halfstrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+			   std::vector<int> distrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS]);
+
   /** Maximum number of time bins. */
   enum {MAX_CLCT_BINS = 16};
 
@@ -78,10 +110,14 @@ class CSCCathodeLCTProcessor
   /** Returns vector of CLCTs in the read-out time window, if any. */
   std::vector<CSCCLCTDigi> readoutCLCTs();
 
+  /** Appends the CLCTs in the read-out time window, if any, to the given
+      vector. */
+  void readoutCLCTs(std::vector<CSCCLCTDigi>& clcts);
+
   /** Returns vector of all found CLCTs, if any. */
   std::vector<CSCCLCTDigi> getCLCTs();
 
-  std::vector<int> preTriggerBXs() const {return thePreTriggerBXs;}
+  const std::vector<int>& preTriggerBXs() const {return thePreTriggerBXs;}
 
   static void distripStagger(int stag_triad[CSCConstants::MAX_NUM_STRIPS],
 			     int stag_time[CSCConstants::MAX_NUM_STRIPS],
@@ -93,6 +129,11 @@ class CSCCathodeLCTProcessor
    **/
   void setRing(unsigned r) {theRing = r;}
 
+  /** Id of the chamber whose digis the processor reads (ring 4 for the
+      ME1/a processor of the upgrade ME1/1 TMB). */
+  CSCDetId chamberId() const
+    {return CSCDetId(theEndcap, theStation, theRing, theChamber, 0);}
+
   /** Pre-defined patterns. */
   enum {NUM_PATTERN_STRIPS = 26};
   static const int pre_hit_pattern[2][NUM_PATTERN_STRIPS];
@@ -117,6 +158,10 @@ class CSCCathodeLCTProcessor
    *                   3: add special-purpose prints. */
   int infoV;
 
+  /** Trace of this chamber, if it is traced, and its raw id. */
+  CSCTriggerTrace* trace;
+  uint32_t traceId;
+
   /** Chamber id (trigger-type labels). */
   const unsigned theEndcap;
   const unsigned theStation;
@@ -135,12 +180,21 @@ class CSCCathodeLCTProcessor
   /** auxiliary string to keep the "(trig. sector 2 subsector 1 id 4)"-like trigger info for a chamber */
   std::string theTrigStr;
   
+  /** Number of strips of the chamber as found in the geometry, and the
+      number of strips this processor runs on: for ME1/1, those of ME1/a
+      or ME1/b or both, depending on the configuration. */
+  int geomStrips;
   int numStrips;
   int stagger[CSCConstants::NUM_LAYERS];
 
-  std::vector<CSCComparatorDigi> digiV[CSCConstants::NUM_LAYERS];
+  /** Comparator digis; in the scratch arena, see attachScratch(). */
+  std::vector<CSCComparatorDigi>* digiV;
   std::vector<int> thePreTriggerBXs;
 
+  /** Hit times on half-strips and di-strips; in the scratch arena. */
+  std::vector<int> (*halfstrip_times)[CSCConstants::NUM_HALF_STRIPS];
+  std::vector<int> (*distrip_times)[CSCConstants::NUM_HALF_STRIPS];
+
   /** Flag for "real" - not idealized - version of the algorithm. */
   bool isMTCC; 
 
@@ -180,6 +234,21 @@ class CSCCathodeLCTProcessor
   /** VK: whether to readout only the earliest two LCTs in readout window */
   bool readout_earliest_2;
 
+  /** Whether to count the layers hit in the 2007 patterns for all key
+      half-strips at once, with bit operations on half-strip bitsets. */
+  bool use_bit_parallel;
+
+  /** Bit-parallel pattern finding: one bit per (key) half-strip. */
+  typedef std::bitset<CSCConstants::NUM_HALF_STRIPS> HalfStripBits;
+
+  /** Version of the CLCT algorithm, chosen once from the firmware
+      generation and the feature flags by selectAlgorithm(). */
+  enum AlgoVersion {ALGO_IDEALIZED, ALGO_MTCC, ALGO_TMB07, ALGO_SLHC};
+  AlgoVersion algo_version;
+
+  /** Select the algorithm variants for the current configuration. */
+  void selectAlgorithm();
+
   /** Default values of configuration parameters. */
   static const unsigned int def_fifo_tbins,  def_fifo_pretrig;
   static const unsigned int def_hit_persist, def_drift_delay;
@@ -257,19 +326,115 @@ class CSCCathodeLCTProcessor
   bool ptnFinding(
       const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
       const int nStrips, const unsigned int bx_time);
+
+  /** Pattern finding kernels, specialized at compile time on whether the
+      corrected bx (median start time of the pattern hits) is computed. */
+  template <bool CorrectedBx>
+  bool ptnFindingScalar(
+      const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+      const int nStrips, const unsigned int bx_time);
+  template <bool CorrectedBx>
+  bool ptnFindingBitParallel(
+      const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+      const int nStrips, const unsigned int bx_time);
+  typedef bool (CSCCathodeLCTProcessor::*PtnFindingKernel)(
+      const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+      const int nStrips, const unsigned int bx_time);
+  PtnFindingKernel ptn_finding_kernel;
+  int pulseStartBx(
+      const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+      const int layer, const int hstrip, const unsigned int bx_time) const;
+  void setFirstBxCorrected(const int key_hstrip, const unsigned int bx_time,
+			   int* hit_times, const int n_times);
+
+  /** Numbers of layers hit in the patterns of every key half-strip, as
+      found by ptnFinding(), kept up to date from one bx to the next by the
+      CLCT state machine: only pulses rising or falling at a bx change
+      them. */
+  struct PatternCounts {
+    /** hit cells per key half-strip, pattern id and layer */
+    unsigned char cells[CSCConstants::NUM_HALF_STRIPS][CSCConstants::NUM_CLCT_PATTERNS][CSCConstants::NUM_LAYERS];
+    /** layers hit per key half-strip and pattern id */
+    unsigned char layers[CSCConstants::NUM_HALF_STRIPS][CSCConstants::NUM_CLCT_PATTERNS];
+    /** half-strips with pulses on, per layer */
+    int strips_on[CSCConstants::NUM_LAYERS];
+    /** (key, pattern id) pairs with at least nplanes_hit_pattern layers hit */
+    int n_busy;
+  };
+  void initPatternCounts(
+      const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+      const int nStrips, const unsigned int bx_time, PatternCounts& counts) const;
+  void updatePatternCounts(
+      const unsigned int pulse[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+      const int nStrips, const unsigned int bx_time, PatternCounts& counts) const;
+  void addPatternHit(const int layer, const int hstrip, const int nStrips,
+		     const int delta, PatternCounts& counts) const;
+  bool hitsInTime(const PatternCounts& counts) const;
+  unsigned int patternNhits(const PatternCounts& counts,
+			    const int key_hstrip) const;
   void markBusyKeys(const int best_hstrip, const int best_patid,
 		    int quality[CSCConstants::NUM_HALF_STRIPS]);
 
-  unsigned int best_pid[CSCConstants::NUM_HALF_STRIPS];
-  unsigned int nhits[CSCConstants::NUM_HALF_STRIPS];
-  int first_bx_corrected[CSCConstants::NUM_HALF_STRIPS];
+  /** Records the pre-triggered key half-strips into the trace. */
+  void tracePreTriggers(const int bx, const int nStrips);
+
+  /** Cells of the 2007 patterns in the form the pattern loops use: for
+      every pattern id, the half-strip offsets of the cells from the key
+      half-strip, grouped by layer.  The cells of layer l are
+      [layer_begin[l], layer_begin[l+1]). */
+  struct PatternCells {
+    int layer_begin[CSCConstants::NUM_CLCT_PATTERNS][CSCConstants::NUM_LAYERS+1];
+    int offset[CSCConstants::NUM_CLCT_PATTERNS][NUM_PATTERN_HALFSTRIPS];
+  };
+
+  /** Cells of the 2007 patterns; built once from pattern2007 and
+      pattern2007_offset and shared by all the processors. */
+  static const PatternCells& patternCells2007();
+  static PatternCells buildPatternCells2007();
+  const PatternCells* pattern_cells;
+
+  /** Pattern finding results per key half-strip; in the scratch arena. */
+  unsigned int* best_pid;
+  unsigned int* nhits;
+  int* first_bx_corrected;
 
   //--------------- Functions for SLHC studies ----------------
 
   std::vector<CSCCLCTDigi> findLCTsSLHC(
     const std::vector<int>  halfstrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS]);
 
-  bool ispretrig[CSCConstants::NUM_HALF_STRIPS];
+  /** Pretriggered key half-strips; in the scratch arena. */
+  bool* ispretrig;
+
+  //--------------------------- Scratch arena ---------------------------------
+  /** Storage of the working arrays above.  Their contents only live during
+      one call to run(), so one arena per thread is shared by all the CLCT
+      processors run on that thread (including the ME1/a and ME1/b ones of
+      an ME1/1 TMB, which are run one after the other); the vectors in it
+      keep their capacity from chamber to chamber. */
+  struct Scratch {
+    std::vector<CSCComparatorDigi> digiV[CSCConstants::NUM_LAYERS];
+    std::vector<int>
+      halfstrip_times[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
+    std::vector<int>
+      distrip_times[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
+    unsigned int best_pid[CSCConstants::NUM_HALF_STRIPS];
+    unsigned int nhits[CSCConstants::NUM_HALF_STRIPS];
+    int first_bx_corrected[CSCConstants::NUM_HALF_STRIPS];
+    bool ispretrig[CSCConstants::NUM_HALF_STRIPS];
+
+    /** Processor the arrays were last attached to. */
+    const CSCCathodeLCTProcessor* owner;
+
+    Scratch() : owner(0) {}
+  };
+
+  /** Scratch arena of the calling thread. */
+  static Scratch& threadScratch();
+
+  /** Point the working arrays to the scratch arena of the calling thread;
+      done on entry to run() and getDigis(). */
+  void attachScratch();
 
   //--------------------------- Auxiliary methods -----------------------------
   /** Dump CLCT configuration parameters. */
@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+//
+//   Class: CSCChamberDigiCapture
+//
+//   Description:
+//     Flat binary file of the per-chamber wire and comparator digis seen
+//     by the emulator, for standalone replay.
+//
+//-----------------------------------------------------------------------------
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCChamberDigiCapture.h>
+
+#include <FWCore/Utilities/interface/Exception.h>
+
+const char CSCChamberDigiCapture::magic[8] = {'C','S','C','D','I','G','I','2'};
+
+CSCChamberDigiCapture::CSCChamberDigiCapture(const std::string& fileName,
+					     uint32_t flags) :
+  CSCFlatRecordFile(fileName)
+{
+  if (!writeHeader(magic, sizeof(Record), flags)) {
+    throw cms::Exception("CSCChamberDigiCapture")
+      << "Error writing capture file " << fileName << "\n";
+  }
+}
+
+std::shared_ptr<CSCChamberDigiCapture>
+CSCChamberDigiCapture::open(const std::string& fileName, uint32_t flags)
+{
+  std::shared_ptr<CSCChamberDigiCapture> capture =
+    std::dynamic_pointer_cast<CSCChamberDigiCapture>(
+      shared(fileName, [&]() -> CSCFlatRecordFile* {
+	  return new CSCChamberDigiCapture(fileName, flags);
+	}));
+  if (!capture) {
+    throw cms::Exception("CSCChamberDigiCapture")
+      << "File " << fileName << " is already written as another kind of file\n";
+  }
+  return capture;
+}
+
+void CSCChamberDigiCapture::write(const std::vector<Record>& records)
+{
+  if (records.empty()) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!CSCFlatRecordFile::write(&records[0], sizeof(Record), records.size())) {
+    throw cms::Exception("CSCChamberDigiCapture")
+      << "Error writing capture file " << fileName() << "\n";
+  }
+}
+
+const CSCChamberDigiCapture::Record*
+CSCChamberDigiCapture::firstRecord(const void* data, size_t size,
+				   uint32_t& flags)
+{
+  return static_cast<const Record*>(
+    CSCFlatRecordFile::firstRecord(data, size, magic, sizeof(Record), flags));
+}
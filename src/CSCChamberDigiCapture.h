@@ -0,0 +1,86 @@
+#ifndef CSCTriggerPrimitives_CSCChamberDigiCapture_h
+#define CSCTriggerPrimitives_CSCChamberDigiCapture_h
+
+/** \class CSCChamberDigiCapture
+ *
+ * Flat binary file of the per-chamber inputs of the emulator, written by
+ * CSCTriggerPrimitivesBuilder in capture mode and read back by standalone
+ * replay programs, which can feed them to the LCT processors and TMBs
+ * without the framework.
+ *
+ * The file is a header followed by fixed-size records, so that it can be
+ * memory-mapped and walked in place.  Each event starts with an EVENT
+ * record giving the number of chambers that follow; each chamber starts
+ * with a CHAMBER record (raw id of the whole chamber, ME1/1 for ME1/a)
+ * giving the geometry the LCT processors were given and the number of
+ * WIRE and COMPARATOR records of its layers that follow.  Only chambers
+ * run by the builder and having digis are written.
+ *
+ * One capture object is shared by all the builders writing to the same
+ * file (one per stream); each event is appended in one piece.  The header
+ * (see CSCFlatRecordFile) holds the magic "CSCDIGI2", sizeof(Record) and
+ * the CaptureFlags of the emulator configuration.
+ *
+ */
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCFlatRecordFile.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+class CSCChamberDigiCapture : public CSCFlatRecordFile
+{
+ public:
+  typedef CSCFlatRecordFile::Header Header;
+
+  /** Flags describing the configuration the inputs were captured with. */
+  enum CaptureFlags {SMART_ME1A_ME1B = 1};
+
+  enum RecordType {EVENT = 0, CHAMBER = 1, WIRE = 2, COMPARATOR = 3};
+
+  /** One record.  For EVENT and CHAMBER records, count is the number of
+   *  chamber or digi records that follow; CHAMBER records also hold the
+   *  number of wire groups of the chamber in channel, and its number of
+   *  strips and the staggering of its layers (bit 8+i for layer i) in
+   *  comparator.  For digi records, rawId is that of the layer, channel is
+   *  the wire group or strip (counted from 1) and word is the time-bin
+   *  word. */
+  struct Record {
+    uint32_t type;
+    uint32_t rawId;
+    uint16_t channel;
+    uint16_t comparator;
+    uint32_t word;
+    uint32_t count() const {return word;}
+    int numWireGroups() const {return channel;}
+    int numStrips() const {return comparator & 0xff;}
+    int stagger(const int i_layer) const {return (comparator >> (8 + i_layer)) & 1;}
+  };
+
+  /** Returns the capture writing to the given file, opening the file if it
+   *  is not open yet.  Throws if it cannot be opened. */
+  static std::shared_ptr<CSCChamberDigiCapture> open(const std::string& fileName,
+						     uint32_t flags);
+
+  /** Appends the records of one event to the file. */
+  void write(const std::vector<Record>& records);
+
+  /** Checks the header at the beginning of a mapped file; returns the
+   *  first record, or 0 if the header is not valid. */
+  static const Record* firstRecord(const void* data, size_t size,
+				   uint32_t& flags);
+
+  static const char magic[8];
+
+ private:
+  /** Opens the file and writes its header. */
+  CSCChamberDigiCapture(const std::string& fileName, uint32_t flags);
+
+  std::mutex mutex_;
+};
+
+#endif
@@ -0,0 +1,46 @@
+//-----------------------------------------------------------------------------
+//
+//   Class: CSCChamberGeometryInfo
+//
+//   Description: 
+//     Snapshot of the geometry of one chamber used by the anode and
+//     cathode LCT processors.
+//
+//-----------------------------------------------------------------------------
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCChamberGeometryInfo.h>
+#include <DataFormats/MuonDetId/interface/CSCDetId.h>
+#include <DataFormats/MuonDetId/interface/CSCTriggerNumbering.h>
+#include <Geometry/CSCGeometry/interface/CSCGeometry.h>
+
+CSCChamberGeometryInfo::CSCChamberGeometryInfo() :
+  exists(false), numWireGroups(0), numStrips(0) {
+  for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
+    stagger[i_layer] = 0;
+}
+
+CSCChamberGeometryInfo
+CSCChamberGeometryInfo::fromGeometry(const CSCGeometry* geom,
+				     unsigned endcap, unsigned station,
+				     unsigned sector, unsigned subsector,
+				     unsigned trigChamber) {
+  CSCChamberGeometryInfo info;
+  // Same lookup as CSCTriggerGeomManager::chamber(), without going through
+  // the process-wide CSCTriggerGeometry.
+  const int ring = CSCTriggerNumbering::ringFromTriggerLabels(station, trigChamber);
+  const int chid = CSCTriggerNumbering::chamberFromTriggerLabels(sector, subsector,
+								station, trigChamber);
+  const CSCChamber* chamber = geom->chamber(CSCDetId(endcap, station, ring, chid, 0));
+  if (chamber) {
+    info.exists = true;
+    info.numWireGroups = chamber->layer(1)->geometry()->numberOfWireGroups();
+    info.numStrips = chamber->layer(1)->geometry()->numberOfStrips();
+    // The geometry gives the staggering as +1 or -1; convert it into the
+    // 1 or 0 half-strip offset used by the cathode LCT processors.
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+      info.stagger[i_layer] =
+	(chamber->layer(i_layer+1)->geometry()->stagger() + 1) / 2;
+    }
+  }
+  return info;
+}
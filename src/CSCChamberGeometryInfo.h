@@ -0,0 +1,49 @@
+#ifndef CSCTriggerPrimitives_CSCChamberGeometryInfo_h
+#define CSCTriggerPrimitives_CSCChamberGeometryInfo_h
+
+/** \class CSCChamberGeometryInfo
+ *
+ * Snapshot of the geometry of one chamber, as needed by the anode and
+ * cathode LCT processors: whether the chamber exists, its numbers of wire
+ * groups and strips, and the staggering of the strips in each layer.
+ *
+ * It is filled by CSCTriggerPrimitivesBuilder only when the CSC geometry
+ * changes and handed to the processors, so that they do not look up the
+ * geometry during the emulation.  The chamber-wide number of strips is
+ * kept as found in the geometry; the split of ME1/1 strips into ME1/a
+ * and ME1/b is made by the cathode LCT processors according to their
+ * configuration.
+ *
+ */
+
+#include <L1Trigger/CSCCommonTrigger/interface/CSCConstants.h>
+
+class CSCGeometry;
+
+class CSCChamberGeometryInfo
+{
+ public:
+  /** Describes a chamber which is not in the geometry. */
+  CSCChamberGeometryInfo();
+
+  /** Takes the description of the chamber with the given trigger labels
+   *  from the given CSC geometry. */
+  static CSCChamberGeometryInfo fromGeometry(const CSCGeometry* geom,
+					     unsigned endcap, unsigned station,
+					     unsigned sector, unsigned subsector,
+					     unsigned trigChamber);
+
+  /** Whether the chamber is defined in the geometry. */
+  bool exists;
+
+  /** Number of wire groups in the chamber. */
+  int numWireGroups;
+
+  /** Number of strips in the chamber (ME1/a and ME1/b together for ME1/1). */
+  int numStrips;
+
+  /** Staggering of the strips in each layer, in half-strips (0 or 1). */
+  int stagger[CSCConstants::NUM_LAYERS];
+};
+
+#endif
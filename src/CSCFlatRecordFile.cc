@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+//
+//   Class: CSCFlatRecordFile
+//
+//   Description:
+//     Base of the flat binary files of fixed-size records written by the
+//     emulator: header, writing and sharing of the file between streams.
+//
+//-----------------------------------------------------------------------------
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCFlatRecordFile.h>
+
+#include <FWCore/Utilities/interface/Exception.h>
+
+#include <cstring>
+#include <map>
+#include <mutex>
+
+namespace {
+  // Files currently open, by file name; the builders of all streams
+  // share them.
+  std::mutex registryMutex;
+  std::map<std::string, std::weak_ptr<CSCFlatRecordFile> > registry;
+}
+
+CSCFlatRecordFile::CSCFlatRecordFile(const std::string& fileName) :
+  file_(fopen(fileName.c_str(), "wb")), fileName_(fileName)
+{
+  if (!file_) {
+    throw cms::Exception("CSCFlatRecordFile")
+      << "Cannot open file " << fileName << " for writing\n";
+  }
+}
+
+CSCFlatRecordFile::~CSCFlatRecordFile()
+{
+  if (file_) fclose(file_);
+}
+
+std::shared_ptr<CSCFlatRecordFile>
+CSCFlatRecordFile::shared(const std::string& fileName,
+			  const std::function<CSCFlatRecordFile*()>& make)
+{
+  std::lock_guard<std::mutex> lock(registryMutex);
+  std::shared_ptr<CSCFlatRecordFile> file = registry[fileName].lock();
+  if (file) return file;
+
+  file.reset(make());
+  registry[fileName] = file;
+  return file;
+}
+
+bool CSCFlatRecordFile::writeHeader(const char magic[8], uint32_t recordSize,
+				    uint32_t param)
+{
+  Header header;
+  memcpy(header.magic, magic, sizeof(header.magic));
+  header.recordSize = recordSize;
+  header.param = param;
+  return write(&header, sizeof(header), 1);
+}
+
+bool CSCFlatRecordFile::write(const void* records, size_t recordSize, size_t n)
+{
+  return file_ && fwrite(records, recordSize, n, file_) == n;
+}
+
+bool CSCFlatRecordFile::close()
+{
+  if (!file_) return false;
+  const bool ok = (fclose(file_) == 0);
+  file_ = 0;
+  return ok;
+}
+
+const void* CSCFlatRecordFile::firstRecord(const void* data, size_t size,
+					   const char magic[8], uint32_t recordSize,
+					   uint32_t& param)
+{
+  if (size < sizeof(Header)) return 0;
+  const Header* header = static_cast<const Header*>(data);
+  if (memcmp(header->magic, magic, sizeof(header->magic)) != 0 ||
+      header->recordSize != recordSize) return 0;
+  param = header->param;
+  return header + 1;
+}
@@ -0,0 +1,72 @@
+#ifndef CSCTriggerPrimitives_CSCFlatRecordFile_h
+#define CSCTriggerPrimitives_CSCFlatRecordFile_h
+
+/** \class CSCFlatRecordFile
+ *
+ * Base of the flat binary files of fixed-size records written by the
+ * emulator for offline programs (CSCChamberDigiCapture, CSCTriggerTrace).
+ * Such a file is a header followed by the records, so that it can be
+ * memory-mapped and walked in place; the header holds the magic of the
+ * kind of file, the size of its records and one word whose meaning
+ * depends on the kind of file.
+ *
+ * The file objects are shared by all the builders (one per stream)
+ * writing to the same file: shared() returns the one already open for a
+ * file name, if any.
+ *
+ */
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <stdint.h>
+#include <stdio.h>
+
+class CSCFlatRecordFile
+{
+ public:
+  /** File header. */
+  struct Header {
+    char magic[8];         // kind of file
+    uint32_t recordSize;   // size of the records
+    uint32_t param;        // depends on the kind of file
+  };
+
+  /** Closes the file, if not done yet. */
+  virtual ~CSCFlatRecordFile();
+
+  /** Checks the header at the beginning of a mapped file against the
+   *  given magic and record size; returns the first record, or 0 if the
+   *  header is not valid.  param is set to the last word of the header. */
+  static const void* firstRecord(const void* data, size_t size,
+				 const char magic[8], uint32_t recordSize,
+				 uint32_t& param);
+
+ protected:
+  /** Opens the file for writing.  Throws if it cannot be opened. */
+  explicit CSCFlatRecordFile(const std::string& fileName);
+
+  /** Returns the file object writing to the given file; if there is none,
+   *  makes it with make() and keeps it while it is in use. */
+  static std::shared_ptr<CSCFlatRecordFile>
+    shared(const std::string& fileName,
+	   const std::function<CSCFlatRecordFile*()>& make);
+
+  /** Writes a header; returns false on error. */
+  bool writeHeader(const char magic[8], uint32_t recordSize, uint32_t param);
+
+  /** Writes n records of the given size; returns false on error. */
+  bool write(const void* records, size_t recordSize, size_t n);
+
+  /** Closes the file; returns false on error. */
+  bool close();
+
+  const std::string& fileName() const {return fileName_;}
+
+ private:
+  FILE* file_;
+  std::string fileName_;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef CSCTriggerPrimitives_CSCMedianBx_h
+#define CSCTriggerPrimitives_CSCMedianBx_h
+
+/** \file CSCMedianBx.h
+ *
+ * Corrected bx of an LCT, shared by the anode and cathode LCT processors:
+ * the median of the start times of the hits in its pattern.
+ *
+ */
+
+#include <algorithm>
+
+/** Median of n_times > 0 hit times; for an even number of hits, the
+ *  truncated average of the two middle ones.  The times are partially
+ *  reordered in place. */
+inline int cscMedianBx(int* bx_times, const int n_times) {
+  int* mid = bx_times + n_times/2;
+  std::nth_element(bx_times, mid, bx_times + n_times);
+  if ((n_times % 2) == 1) return *mid;
+  const int lower = *std::max_element(bx_times, mid);
+  return (lower + *mid)/2;
+}
+
+#endif
@@ -36,9 +36,13 @@
 //-----------------------------------------------------------------------------
 
 #include <L1Trigger/CSCTriggerPrimitives/src/CSCMotherboard.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesStats.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerTrace.h>
 #include <FWCore/MessageLogger/interface/MessageLogger.h>
 #include <DataFormats/MuonDetId/interface/CSCTriggerNumbering.h>
 
+#include <atomic>
+
 // Default values of configuration parameters.
 const unsigned int CSCMotherboard::def_mpc_block_me1a      = 1;
 const unsigned int CSCMotherboard::def_alct_trig_enable    = 0;
@@ -55,8 +59,6 @@ CSCMotherboard::CSCMotherboard(unsigned endcap, unsigned station,
                    theSubsector(subsector), theTrigChamber(chamber) {
   // Normal constructor.  -JM
   // Pass ALCT, CLCT, and common parameters on to ALCT and CLCT processors.
-  static bool config_dumped = false;
-
   // Some configuration parameters and some details of the emulator
   // algorithms depend on whether we want to emulate the trigger logic
   // used in TB/MTCC or its idealized version (the latter was used in MC
@@ -118,6 +120,8 @@ CSCMotherboard::CSCMotherboard(unsigned endcap, unsigned station,
   readout_earliest_2 = tmbParams.getUntrackedParameter<bool>("tmbReadoutEarliest2",false);
 
   infoV = tmbParams.getUntrackedParameter<int>("verbosity", 0);
+  trace = 0;
+  traceId = 0;
 
   alct = new CSCAnodeLCTProcessor(endcap, station, sector, subsector, chamber, alctParams, commonParams);
   clct = new CSCCathodeLCTProcessor(endcap, station, sector, subsector, chamber, clctParams, commonParams, tmbParams);
@@ -126,9 +130,10 @@ CSCMotherboard::CSCMotherboard(unsigned endcap, unsigned station,
 
   // Check and print configuration parameters.
   checkConfigParameters();
-  if (infoV > 0 && !config_dumped) {
+  // Dumped once per process, by whichever board gets here first.
+  static std::atomic<bool> config_dumped(false);
+  if (infoV > 0 && !config_dumped.exchange(true)) {
     dumpConfigParams();
-    config_dumped = true;
   }
 
   // test to make sure that what goes into a correlated LCT is also what
@@ -140,12 +145,13 @@ CSCMotherboard::CSCMotherboard() :
                    theEndcap(1), theStation(1), theSector(1),
                    theSubsector(1), theTrigChamber(1) {
   // Constructor used only for testing.  -JM
-  static bool config_dumped = false;
-
   isMTCC  = false;
   isTMB07 = true;
+  isSLHC  = false;
 
   early_tbins = 4;
+  drop_used_alcts = true;
+  readout_earliest_2 = false;
 
   alct = new CSCAnodeLCTProcessor();
   clct = new CSCCathodeLCTProcessor();
@@ -157,12 +163,14 @@ CSCMotherboard::CSCMotherboard() :
   tmb_l1a_window_size = def_tmb_l1a_window_size;
 
   infoV = 2;
+  trace = 0;
+  traceId = 0;
 
   // Check and print configuration parameters.
   checkConfigParameters();
-  if (infoV > 0 && !config_dumped) {
+  static std::atomic<bool> config_dumped(false);
+  if (infoV > 0 && !config_dumped.exchange(true)) {
     dumpConfigParams();
-    config_dumped = true;
   }
 }
 
@@ -182,7 +190,6 @@ void CSCMotherboard::clear() {
 
 // Set configuration parameters obtained via EventSetup mechanism.
 void CSCMotherboard::setConfigParameters(const CSCDBL1TPParameters* conf) {
-  static bool config_dumped = false;
 
   // Config. parameters for the TMB itself.
   mpc_block_me1a         = conf->tmbMpcBlockMe1a();
@@ -198,12 +205,35 @@ void CSCMotherboard::setConfigParameters(const CSCDBL1TPParameters* conf) {
 
   // Check and print configuration parameters.
   checkConfigParameters();
-  if (!config_dumped) {
+  static std::atomic<bool> config_dumped(false);
+  if (!config_dumped.exchange(true)) {
     dumpConfigParams();
-    config_dumped = true;
   }
 }
 
+// Set the geometry of the chamber, taken when the CSC geometry changes.
+void CSCMotherboard::setChamberGeometry(const CSCChamberGeometryInfo& info) {
+  alct->setChamberGeometry(info);
+  clct->setChamberGeometry(info);
+}
+
+void CSCMotherboard::setVerbosity(const int verbosity) {
+  infoV = verbosity;
+  alct->setVerbosity(verbosity);
+  clct->setVerbosity(verbosity);
+}
+
+void CSCMotherboard::setTrace(CSCTriggerTrace* t) {
+  trace = t;
+  traceId = CSCDetId(theEndcap, theStation,
+                     CSCTriggerNumbering::ringFromTriggerLabels(theStation, theTrigChamber),
+                     CSCTriggerNumbering::chamberFromTriggerLabels(theSector, theSubsector,
+                                                                   theStation, theTrigChamber),
+                     0).rawId();
+  alct->setTrace(t);
+  clct->setTrace(t);
+}
+
 void CSCMotherboard::checkConfigParameters() {
   // Make sure that the parameter values are within the allowed range.
 
@@ -275,6 +305,9 @@ void CSCMotherboard::run(
   alct->run(w_times);            // run anode LCT
   clct->run(hs_times, ds_times); // run cathodeLCT
 
+  CSCTP_TIME(theStation,
+	     CSCTriggerNumbering::ringFromTriggerLabels(theStation, theTrigChamber),
+	     CORRELATE_LCTS);
   int bx_alct_matched = 0;
   for (int bx_clct = 0; bx_clct < CSCCathodeLCTProcessor::MAX_CLCT_BINS;
        bx_clct++) {
@@ -328,6 +361,9 @@ CSCMotherboard::run(const CSCWireDigiCollection* wiredc,
       std::vector<CSCCLCTDigi> clctV = clct->run(compdc); // run cathodeLCT
     }
 
+    CSCTP_TIME(theStation,
+	       CSCTriggerNumbering::ringFromTriggerLabels(theStation, theTrigChamber),
+	       CORRELATE_LCTS);
     int used_alct_mask[20];
     for (int a=0;a<20;++a) used_alct_mask[a]=0;
 
@@ -416,12 +452,17 @@ CSCMotherboard::run(const CSCWireDigiCollection* wiredc,
   }
 }
 
-// Returns vector of read-out correlated LCTs, if any.  Starts with
-// the vector of all found LCTs and selects the ones in the read-out
-// time window.
+// Returns vector of read-out correlated LCTs, if any.
 std::vector<CSCCorrelatedLCTDigi> CSCMotherboard::readoutLCTs() {
   std::vector<CSCCorrelatedLCTDigi> tmpV;
+  readoutLCTs(tmpV);
+  return tmpV;
+}
 
+// Appends read-out correlated LCTs, if any, to the given vector.  Goes
+// over all found LCTs, in the order of getLCTs(), and selects the ones in
+// the read-out time window.
+void CSCMotherboard::readoutLCTs(std::vector<CSCCorrelatedLCTDigi>& lcts) {
   // The start time of the L1A*LCT coincidence window should be related
   // to the fifo_pretrig parameter, but I am not completely sure how.
   // Just choose it such that the window is centered at bx=7.  This may
@@ -429,35 +470,42 @@ std::vector<CSCCorrelatedLCTDigi> CSCMotherboard::readoutLCTs() {
   //static int early_tbins = 4;
   
   // Empirical correction to match 2009 collision data (firmware change?)
-  static int lct_bins   = tmb_l1a_window_size;
-  static int late_tbins = early_tbins + lct_bins;
+  int lct_bins   = tmb_l1a_window_size;
+  int late_tbins = early_tbins + lct_bins;
+
+  if (late_tbins > MAX_LCT_BINS-1) late_tbins = MAX_LCT_BINS-1;
 
-  static int ifois = 0;
-  if (ifois == 0) {
+  static std::atomic<bool> readout_checked(false);
+  if (!readout_checked.exchange(true)) {
     if (infoV >= 0 && early_tbins < 0) {
       edm::LogWarning("L1CSCTPEmulatorSuspiciousParameters")
         << "+++ early_tbins = " << early_tbins
         << "; in-time LCTs are not getting read-out!!! +++" << "\n";
     }
 
-    if (late_tbins > MAX_LCT_BINS-1) {
+    if (early_tbins + lct_bins > MAX_LCT_BINS-1) {
       if (infoV >= 0) edm::LogWarning("L1CSCTPEmulatorSuspiciousParameters")
-        << "+++ Allowed range of time bins, [0-" << late_tbins
+        << "+++ Allowed range of time bins, [0-" << early_tbins + lct_bins
         << "] exceeds max allowed, " << MAX_LCT_BINS-1 << " +++\n"
         << "+++ Set late_tbins to max allowed +++\n";
-      late_tbins = MAX_LCT_BINS-1;
     }
-    ifois = 1;
   }
 
-  // Start from the vector of all found correlated LCTs and select
-  // those within the LCT*L1A coincidence window.
+  bool me11 = (theStation == 1 &&
+               CSCTriggerNumbering::ringFromTriggerLabels(theStation,
+                                                          theTrigChamber)==1);
+
+  // Go over all found correlated LCTs and select those within the LCT*L1A
+  // coincidence window.
   int bx_readout = -1;
-  std::vector<CSCCorrelatedLCTDigi> all_lcts = getLCTs();
-  for (std::vector <CSCCorrelatedLCTDigi>::const_iterator plct =
-       all_lcts.begin(); plct != all_lcts.end(); plct++) {
+  for (int i_lct = 0; i_lct < 2*MAX_LCT_BINS; i_lct++) {
+    const CSCCorrelatedLCTDigi* plct =
+      (i_lct%2 == 0) ? &firstLCT[i_lct/2] : &secondLCT[i_lct/2];
     if (!plct->isValid()) continue;
 
+    // Do not report LCTs found in ME1/A if mpc_block_me1/a is set.
+    if (mpc_block_me1a && me11 && plct->getStrip() > 127) continue;
+
     int bx = (*plct).getBX();
     // Skip LCTs found too early relative to L1Accept.
     if (bx <= early_tbins) {
@@ -484,14 +532,13 @@ std::vector<CSCCorrelatedLCTDigi> CSCMotherboard::readoutLCTs() {
     // currently there is room just for two.
     if (readout_earliest_2) {
       if (bx_readout == -1 || bx == bx_readout) {
-        tmpV.push_back(*plct);
+        lcts.push_back(*plct);
         if (bx_readout == -1) bx_readout = bx;
       }
     }
     // if readout_earliest_2 == false, save all LCTs
-    else tmpV.push_back(*plct);
+    else lcts.push_back(*plct);
   }
-  return tmpV;
 }
 
 // Returns vector of all found correlated LCTs, if any.
@@ -585,6 +632,9 @@ CSCCorrelatedLCTDigi CSCMotherboard::constructLCTs(const CSCALCTDigi& aLCT,
   CSCCorrelatedLCTDigi thisLCT(trknmb, 1, quality, aLCT.getKeyWG(),
                                cLCT.getKeyStrip(), pattern, cLCT.getBend(),
                                bx, 0, 0, 0, theTrigChamber);
+  if (trace) trace->record(traceId, CSCTriggerTrace::TMB,
+                           CSCTriggerTrace::CORRELATION, bx, aLCT.getKeyWG(),
+                           cLCT.getKeyStrip(), quality);
   return thisLCT;
 }
 
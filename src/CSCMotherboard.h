@@ -39,6 +39,8 @@
 #include <L1Trigger/CSCTriggerPrimitives/src/CSCCathodeLCTProcessor.h>
 #include <DataFormats/CSCDigi/interface/CSCCorrelatedLCTDigi.h>
 
+class CSCTriggerTrace;
+
 class CSCMotherboard
 {
  public:
@@ -65,6 +67,10 @@ class CSCMotherboard
   /** Returns vector of correlated LCTs in the read-out time window, if any. */
   std::vector<CSCCorrelatedLCTDigi> readoutLCTs();
 
+  /** Appends the correlated LCTs in the read-out time window, if any, to
+      the given vector. */
+  void readoutLCTs(std::vector<CSCCorrelatedLCTDigi>& lcts);
+
   /** Returns vector of all found correlated LCTs, if any. */
   std::vector<CSCCorrelatedLCTDigi> getLCTs();
 
@@ -75,6 +81,18 @@ class CSCMotherboard
   /** Set configuration parameters obtained via EventSetup mechanism. */
   void setConfigParameters(const CSCDBL1TPParameters* conf);
 
+  /** Passes a snapshot of the chamber geometry on to the cathode and anode
+      LCT processors. */
+  void setChamberGeometry(const CSCChamberGeometryInfo& info);
+
+  /** Sets the verbosity level of the TMB and of its LCT processors; used
+      in standalone tests. */
+  void setVerbosity(const int verbosity);
+
+  /** Records the decisions of the TMB and of its LCT processors into the
+      given trace; 0 turns tracing off. */
+  void setTrace(CSCTriggerTrace* trace);
+
   /** Anode LCT processor. */
   CSCAnodeLCTProcessor* alct;
 
@@ -88,6 +106,10 @@ class CSCMotherboard
    *                   1: print LCTs found. */
   int infoV;
 
+  /** Trace of this chamber, if it is traced, and its raw id. */
+  CSCTriggerTrace* trace;
+  uint32_t traceId;
+
   /** Chamber id (trigger-type labels). */
   const unsigned theEndcap;
   const unsigned theStation;
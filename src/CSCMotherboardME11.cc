@@ -13,6 +13,7 @@
 //-----------------------------------------------------------------------------
 
 #include <L1Trigger/CSCTriggerPrimitives/src/CSCMotherboardME11.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesStats.h>
 //#include <Utilities/Timing/interface/TimingReport.h>
 #include <FWCore/MessageLogger/interface/MessageLogger.h>
 #include <DataFormats/MuonDetId/interface/CSCTriggerNumbering.h>
@@ -115,9 +116,26 @@ CSCMotherboardME11::CSCMotherboardME11(unsigned endcap, unsigned station,
 CSCMotherboardME11::CSCMotherboardME11() : CSCMotherboard()
 {
   // Constructor used only for testing.
-
+  // Upgrade ME1/1 defaults, as in the tmbSLHC parameter set.
+  isSLHC = true;
+  smartME1aME1b = true;
+  disableME1a = false;
+  gangedME1a = false;
+  drop_used_alcts = false;
+  match_earliest_alct_me11_only = false;
+  match_earliest_clct_me11_only = false;
+  clct_to_alct = false;
+  drop_used_clcts = false;
+  tmb_cross_bx_algo = 1;
+  max_me11_lcts = 2;
+
+  // Pass the flags on to the LCT processors, as the normal constructor
+  // does through the common parameters.
+  alct->setME11Flags(isSLHC, disableME1a);
+  clct->setME11Flags(isSLHC, smartME1aME1b, disableME1a, gangedME1a);
   clct1a = new CSCCathodeLCTProcessor();
   clct1a->setRing(4);
+  clct1a->setME11Flags(isSLHC, smartME1aME1b, disableME1a, gangedME1a);
 
   pref[0] = match_trig_window_size/2;
   for (unsigned int m=2; m<match_trig_window_size; m+=2)
@@ -160,6 +178,31 @@ void CSCMotherboardME11::setConfigParameters(const CSCDBL1TPParameters* conf)
   // No config. parameters in DB for the TMB itself yet.
 }
 
+// Set the geometry of the chamber, taken when the CSC geometry changes.
+// ME1/a and ME1/b share the ME1/1 geometry; the CLCT processors split the
+// strips according to their ring.
+void CSCMotherboardME11::setChamberGeometry(const CSCChamberGeometryInfo& info)
+{
+  alct->setChamberGeometry(info);
+  clct->setChamberGeometry(info);
+  clct1a->setChamberGeometry(info);
+}
+
+
+// Set the verbosity level; used in standalone tests.
+void CSCMotherboardME11::setVerbosity(const int verbosity)
+{
+  CSCMotherboard::setVerbosity(verbosity);
+  clct1a->setVerbosity(verbosity);
+}
+
+
+void CSCMotherboardME11::setTrace(CSCTriggerTrace* trace)
+{
+  CSCMotherboard::setTrace(trace);
+  clct1a->setTrace(trace);
+}
+
 
 void CSCMotherboardME11::run(const CSCWireDigiCollection* wiredc,
                              const CSCComparatorDigiCollection* compdc)
@@ -177,6 +220,41 @@ void CSCMotherboardME11::run(const CSCWireDigiCollection* wiredc,
   clctV1b = clct->run(compdc); // run cathodeLCT in ME1/b
   clctV1a = clct1a->run(compdc); // run cathodeLCT in ME1/a
 
+  matchLCTs();
+}
+
+
+void CSCMotherboardME11::run(
+ const std::vector<int> w_times[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES],
+ const std::vector<int> hs_times1b[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+ const std::vector<int> ds_times1b[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+ const std::vector<int> hs_times1a[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+ const std::vector<int> ds_times1a[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS])
+{
+  clear();
+
+  if (!( alct && clct &&  clct1a && smartME1aME1b))
+  {
+    if (infoV >= 0) edm::LogError("L1CSCTPEmulatorSetupError")
+      << "+++ run() called for non-existing ALCT/CLCT processor! +++ \n";
+    return;
+  }
+
+  alct->run(w_times);
+  alctV = alct->getALCTs();
+  clct->run(hs_times1b, ds_times1b);
+  clctV1b = clct->getCLCTs();
+  clct1a->run(hs_times1a, ds_times1a);
+  clctV1a = clct1a->getCLCTs();
+
+  matchLCTs();
+}
+
+
+void CSCMotherboardME11::matchLCTs()
+{
+  CSCTP_TIME(1, 1, CORRELATE_LCTS);
+
   //int n_clct_a=0, n_clct_b=0;
   //if (clct1a->bestCLCT[6].isValid() && clct1a->bestCLCT[6].getBX()==6) n_clct_a++;
   //if (clct1a->secondCLCT[6].isValid() && clct1a->secondCLCT[6].getBX()==6) n_clct_a++;
@@ -402,13 +480,33 @@ std::vector<CSCCorrelatedLCTDigi> CSCMotherboardME11::readoutLCTs1b()
 }
 
 
-// Returns vector of read-out correlated LCTs, if any.  Starts with
-// the vector of all found LCTs and selects the ones in the read-out
-// time window.
+void CSCMotherboardME11::readoutLCTs1a(std::vector<CSCCorrelatedLCTDigi>& lcts)
+{
+  readoutLCTs(ME1A, lcts);
+}
+
+
+void CSCMotherboardME11::readoutLCTs1b(std::vector<CSCCorrelatedLCTDigi>& lcts)
+{
+  readoutLCTs(ME1B, lcts);
+}
+
+
+// Returns vector of read-out correlated LCTs, if any.
 std::vector<CSCCorrelatedLCTDigi> CSCMotherboardME11::readoutLCTs(int me1ab)
 {
   std::vector<CSCCorrelatedLCTDigi> tmpV;
+  readoutLCTs(me1ab, tmpV);
+  return tmpV;
+}
 
+
+// Appends read-out correlated LCTs, if any, to the given vector.  Goes
+// over all found LCTs, in the order of getLCTs1a() and getLCTs1b(), and
+// selects the ones in the read-out time window.
+void CSCMotherboardME11::readoutLCTs(int me1ab,
+				     std::vector<CSCCorrelatedLCTDigi>& lcts)
+{
   // The start time of the L1A*LCT coincidence window should be related
   // to the fifo_pretrig parameter, but I am not completely sure how.
   // Just choose it such that the window is centered at bx=7.  This may
@@ -416,40 +514,44 @@ std::vector<CSCCorrelatedLCTDigi> CSCMotherboardME11::readoutLCTs(int me1ab)
   //static int early_tbins = 4;
   // The number of LCT bins in the read-out is given by the
   // tmb_l1a_window_size parameter, forced to be odd
-  static int lct_bins   = 
+  int lct_bins   = 
     (tmb_l1a_window_size % 2 == 0) ? tmb_l1a_window_size + 1 : tmb_l1a_window_size;
-  static int late_tbins = early_tbins + lct_bins;
+  int late_tbins = early_tbins + lct_bins;
 
 
-  // Start from the vector of all found correlated LCTs and select
-  // those within the LCT*L1A coincidence window.
+  // No LCTs are reported from disabled ME1a.
+  if (me1ab == ME1A && (mpc_block_me1a || disableME1a)) return;
+  if (me1ab != ME1A && me1ab != ME1B) return;
+  const CSCCorrelatedLCTDigi (*all_lcts)[15][2] =
+    (me1ab == ME1A) ? allLCTs1a : allLCTs1b;
+
+  // Go over all found correlated LCTs and select those within the LCT*L1A
+  // coincidence window.
   int bx_readout = -1;
-  std::vector<CSCCorrelatedLCTDigi> all_lcts;
-  if (me1ab == ME1A) all_lcts = getLCTs1a();
-  if (me1ab == ME1B) all_lcts = getLCTs1b();
-  std::vector <CSCCorrelatedLCTDigi>::const_iterator plct = all_lcts.begin();
-  for (; plct != all_lcts.end(); plct++)
-  {
-    if (!plct->isValid()) continue;
+  for (int lct_bx = 0; lct_bx < MAX_LCT_BINS; lct_bx++)
+    for (unsigned int mbx = 0; mbx < match_trig_window_size; mbx++)
+      for (int i = 0; i < 2; i++)
+      {
+        const CSCCorrelatedLCTDigi* plct = &all_lcts[lct_bx][mbx][i];
+        if (!plct->isValid()) continue;
 
-    int bx = (*plct).getBX();
-    // Skip LCTs found too early relative to L1Accept.
-    if (bx <= early_tbins) continue;
+        int bx = (*plct).getBX();
+        // Skip LCTs found too early relative to L1Accept.
+        if (bx <= early_tbins) continue;
 
-    // Skip LCTs found too late relative to L1Accept.
-    if (bx > late_tbins) continue;
+        // Skip LCTs found too late relative to L1Accept.
+        if (bx > late_tbins) continue;
 
-    // If (readout_earliest_2) take only LCTs in the earliest bx in the read-out window:
-    // in digi->raw step, LCTs have to be packed into the TMB header, and
-    // currently there is room just for two.
-    if (readout_earliest_2 && (bx_readout == -1 || bx == bx_readout) )
-    {
-      tmpV.push_back(*plct);
-      if (bx_readout == -1) bx_readout = bx;
-    }
-    else tmpV.push_back(*plct);
-  }
-  return tmpV;
+        // If (readout_earliest_2) take only LCTs in the earliest bx in the read-out window:
+        // in digi->raw step, LCTs have to be packed into the TMB header, and
+        // currently there is room just for two.
+        if (readout_earliest_2 && (bx_readout == -1 || bx == bx_readout) )
+        {
+          lcts.push_back(*plct);
+          if (bx_readout == -1) bx_readout = bx;
+        }
+        else lcts.push_back(*plct);
+      }
 }
 
 
@@ -37,6 +37,14 @@ class CSCMotherboardME11 : public CSCMotherboard
   void run(const CSCWireDigiCollection* wiredc,
 	   const CSCComparatorDigiCollection* compdc);
 
+  /** Run function for standalone tests: same as above, but takes the
+      wire times and the ME1/b and ME1/a half-strip and di-strip times. */
+  void run(const std::vector<int> w_times[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES],
+	   const std::vector<int> hs_times1b[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+	   const std::vector<int> ds_times1b[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+	   const std::vector<int> hs_times1a[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+	   const std::vector<int> ds_times1a[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS]);
+
   /** Returns vectors of found correlated LCTs in ME1a and ME1b, if any. */
   std::vector<CSCCorrelatedLCTDigi> getLCTs1a();
   std::vector<CSCCorrelatedLCTDigi> getLCTs1b();
@@ -55,6 +63,18 @@ class CSCMotherboardME11 : public CSCMotherboard
   /** Set configuration parameters obtained via EventSetup mechanism. */
   void setConfigParameters(const CSCDBL1TPParameters* conf);
 
+  /** Passes a snapshot of the chamber geometry on to the cathode (ME1/a
+      and ME1/b) and anode LCT processors. */
+  void setChamberGeometry(const CSCChamberGeometryInfo& info);
+
+  /** Sets the verbosity level of the TMB and of its LCT processors (ME1/a
+      included); used in standalone tests. */
+  void setVerbosity(const int verbosity);
+
+  /** Records the decisions of the TMB and of its LCT processors (ME1/a
+      included) into the given trace; 0 turns tracing off. */
+  void setTrace(CSCTriggerTrace* trace);
+
   /** additional Cathode LCT processor for ME1a */
   CSCCathodeLCTProcessor* clct1a;
 
@@ -62,6 +82,12 @@ class CSCMotherboardME11 : public CSCMotherboard
   std::vector<CSCCorrelatedLCTDigi> readoutLCTs1b();
   std::vector<CSCCorrelatedLCTDigi> readoutLCTs(int me1ab);
 
+  /** Append the correlated LCTs in ME1a and ME1b in the read-out time
+      window, if any, to the given vector. */
+  void readoutLCTs1a(std::vector<CSCCorrelatedLCTDigi>& lcts);
+  void readoutLCTs1b(std::vector<CSCCorrelatedLCTDigi>& lcts);
+  void readoutLCTs(int me1ab, std::vector<CSCCorrelatedLCTDigi>& lcts);
+
  private:
 
   /** labels for ME1a and ME1B */
@@ -95,6 +121,10 @@ class CSCMotherboardME11 : public CSCMotherboard
 		     CSCCLCTDigi bestCLCT, CSCCLCTDigi secondCLCT,
 		     CSCCorrelatedLCTDigi& lct1, CSCCorrelatedLCTDigi& lct2, int me);
 
+  /** Matches the ALCTs and the ME1/b and ME1/a CLCTs found by the
+      processors into correlated LCTs. */
+  void matchLCTs();
+
   std::vector<CSCALCTDigi> alctV;
   std::vector<CSCCLCTDigi> clctV1b;
   std::vector<CSCCLCTDigi> clctV1a;
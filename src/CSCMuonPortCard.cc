@@ -23,6 +23,47 @@
 #include "L1Trigger/CSCTriggerPrimitives/src/CSCMuonPortCard.h"
 #include "L1Trigger/CSCCommonTrigger/interface/CSCConstants.h"
 #include <algorithm>
+#include <functional>
+
+namespace {
+  // Position of a stub in the list of stubs of the port card: the
+  // (sub)sector it is sorted in, and its BX.  The subsector only matters
+  // in station 1.
+  struct StubSlot {
+    StubSlot(const unsigned endcap, const unsigned station,
+	     const unsigned sector, const unsigned subsector, const int bx) :
+      slot(sectorSlot(endcap, station, sector, subsector)), bx(bx) {}
+    explicit StubSlot(const csctf::TrackStub& stub) :
+      slot(sectorSlot(stub.endcap(), stub.station(), stub.sector(),
+		      stub.subsector())), bx(stub.BX()) {}
+    static unsigned sectorSlot(const unsigned endcap, const unsigned station,
+			       const unsigned sector, const unsigned subsector) {
+      return ((endcap*8 + station)*16 + sector)*4 + (station == 1 ? subsector : 0);
+    }
+    bool operator<(const StubSlot& rhs) const {
+      return (slot < rhs.slot) || (slot == rhs.slot && bx < rhs.bx);
+    }
+    unsigned slot;
+    int bx;
+  };
+
+  struct StubSlotLess {
+    bool operator()(const csctf::TrackStub& a, const csctf::TrackStub& b) const {
+      return StubSlot(a) < StubSlot(b);
+    }
+    bool operator()(const csctf::TrackStub& a, const StubSlot& b) const {
+      return StubSlot(a) < b;
+    }
+    bool operator()(const StubSlot& a, const csctf::TrackStub& b) const {
+      return a < StubSlot(b);
+    }
+  };
+
+  // Quality 0 and non-valid LCTs do not come through the portcard.
+  bool isBadStub(const csctf::TrackStub& stub) {
+    return !(stub.getQuality() && stub.isValid());
+  }
+}
 
 CSCMuonPortCard::CSCMuonPortCard()
 {
@@ -43,8 +84,9 @@ CSCMuonPortCard::CSCMuonPortCard(const edm::ParameterSet& conf)
 
 void CSCMuonPortCard::loadDigis(const CSCCorrelatedLCTDigiCollection& thedigis)
 {
-  // Put everything from the digi container into a trigger container.
-  // This allows us to sort per BX more easily.
+  // Put everything from the digi container into the list of stubs, and
+  // order it by (sub)sector and BX.  This allows us to sort per BX more
+  // easily.
   clear();
 
   CSCCorrelatedLCTDigiCollection::DigiRangeIterator Citer;
@@ -58,34 +100,41 @@ void CSCMuonPortCard::loadDigis(const CSCCorrelatedLCTDigiCollection& thedigis)
       stubs_.push_back(theStub);
     }
   }
+
+  // Make sure no Quality 0 or non-valid LCTs come through the portcard.
+  stubs_.erase(std::remove_if(stubs_.begin(), stubs_.end(), isBadStub),
+	       stubs_.end());
+
+  std::stable_sort(stubs_.begin(), stubs_.end(), StubSlotLess());
 }
 
 std::vector<csctf::TrackStub> CSCMuonPortCard::sort(const unsigned endcap, const unsigned station, 
-						    const unsigned sector, const unsigned subsector, const int bx)
+						    const unsigned sector, const unsigned subsector, const int bx) const
 {
   std::vector<csctf::TrackStub> result;
   std::vector<csctf::TrackStub>::iterator LCT;
 
-  result = stubs_.get(endcap, station, sector, subsector, bx);
+  // Find the stubs of this (sub)sector and BX.
+  std::pair<std::vector<csctf::TrackStub>::const_iterator,
+            std::vector<csctf::TrackStub>::const_iterator> range =
+    std::equal_range(stubs_.begin(), stubs_.end(),
+		     StubSlot(endcap, station, sector, subsector, bx),
+		     StubSlotLess());
+  if (range.first == range.second) return result;
 
-  // Make sure no Quality 0 or non-valid LCTs come through the portcard.
-  for (LCT = result.begin(); LCT != result.end(); LCT++) {
-    if ( !(LCT->getQuality() && LCT->isValid()) )
-      result.erase(LCT, LCT);
-  }
+  // Sort in the order of decreasing rank, equally ranked stubs keeping
+  // their input order.
+  result.assign(range.first, range.second);
+  std::stable_sort(result.begin(), result.end(), std::greater<csctf::TrackStub>());
 
-  if (result.size()) {
-    std::sort(result.begin(), result.end(), std::greater<csctf::TrackStub>());
-    // Can only return maxStubs or less LCTs per bunch crossing.
-    if (result.size() > max_stubs_)
-      result.erase(result.begin() + max_stubs_, result.end());
+  // Can only return maxStubs or less LCTs per bunch crossing.
+  if (result.size() > max_stubs_)
+    result.erase(result.begin() + max_stubs_, result.end());
 
-
-    // Go through the sorted list and label the LCTs with a sorting number.
-    unsigned i = 0;
-    for (LCT = result.begin(); LCT != result.end(); LCT++)
-      LCT->setMPCLink(++i);
-  }
+  // Go through the sorted list and label the LCTs with a sorting number.
+  unsigned i = 0;
+  for (LCT = result.begin(); LCT != result.end(); LCT++)
+    LCT->setMPCLink(++i);
 
   return result;
 }
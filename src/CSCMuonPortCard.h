@@ -18,7 +18,6 @@
 #include <vector>
 #include <FWCore/ParameterSet/interface/ParameterSet.h>
 #include <DataFormats/CSCDigi/interface/CSCCorrelatedLCTDigiCollection.h>
-#include <DataFormats/L1CSCTrackFinder/interface/CSCTriggerContainer.h>
 #include <DataFormats/L1CSCTrackFinder/interface/TrackStub.h>
 
 
@@ -28,23 +27,26 @@ class CSCMuonPortCard
   CSCMuonPortCard();
   CSCMuonPortCard(const edm::ParameterSet& conf);
 
-  typedef CSCTriggerContainer<csctf::TrackStub> TrackStubList;
-
-
-  // Method to load the content of the digi container into a trigger
-  // container.  This allows us to sort per BX more easily.
+  // Method to load the content of the digi container into the port card.
+  // Quality 0 and non-valid LCTs are dropped, and the others are grouped
+  // by (sub)sector and BX, so that each call to sort() only looks at the
+  // LCTs it sorts.
   void loadDigis(const CSCCorrelatedLCTDigiCollection& thedigis);
 
   // Method to sort all Correlated LCTs generated by the TMB.
   // Returns a vector of TrackStubs indexed by [sorting]
+  // It does not change the port card, so different (sub)sectors and BXs
+  // can be sorted concurrently.
   std::vector<csctf::TrackStub> sort(const unsigned endcap, const unsigned station,
 				     const unsigned sector, const unsigned subsector,
-				     const int bx);
+				     const int bx) const;
 
   void clear() { stubs_.clear(); }
 
  private:
-  CSCTriggerContainer<csctf::TrackStub> stubs_;
+  // Valid LCTs, ordered by (sub)sector and BX, and otherwise in the order
+  // of the digi collection.
+  std::vector<csctf::TrackStub> stubs_;
   unsigned int max_stubs_;
 };
 
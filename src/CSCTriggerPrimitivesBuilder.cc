@@ -18,12 +18,48 @@
 #include <L1Trigger/CSCTriggerPrimitives/src/CSCMotherboard.h>
 #include <L1Trigger/CSCTriggerPrimitives/src/CSCMotherboardME11.h>
 #include <L1Trigger/CSCTriggerPrimitives/src/CSCMuonPortCard.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesStats.h>
 
 #include <FWCore/MessageLogger/interface/MessageLogger.h>
 
-#include <L1Trigger/CSCCommonTrigger/interface/CSCTriggerGeometry.h>
 #include <DataFormats/MuonDetId/interface/CSCTriggerNumbering.h>
 #include <DataFormats/MuonDetId/interface/CSCDetId.h>
+#include <FWCore/Utilities/interface/Exception.h>
+
+#include <cstdio>
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+namespace {
+  // Appends all digis of a staging collection to an output collection,
+  // keeping the order of digis within each DetId.
+  template <class T>
+  void mergeCollection(const T& in, T& out)
+  {
+    for (typename T::DigiRangeIterator it = in.begin(); it != in.end(); ++it)
+      out.put((*it).second, (*it).first);
+  }
+
+  // Parses a chamber name like "ME+1/2/13" (ring 4 for ME1/a).
+  CSCDetId chamberFromName(const std::string& name)
+  {
+    char sign = 0;
+    int stat = 0, ring = 0, cham = 0;
+    char extra = 0;
+    if (sscanf(name.c_str(), "ME%c%d/%d/%d%c", &sign, &stat, &ring, &cham, &extra) != 4 ||
+        (sign != '+' && sign != '-') ||
+        stat < CSCDetId::minStationId() || stat > CSCDetId::maxStationId() ||
+        ring < CSCDetId::minRingId() || ring > CSCDetId::maxRingId() ||
+        cham < CSCDetId::minChamberId() || cham > CSCDetId::maxChamberId())
+    {
+      throw cms::Exception("Configuration")
+        << "CSCTriggerPrimitivesBuilder: illegal chamber name " << name
+        << "; expected e.g. ME+1/2/13\n";
+    }
+    return CSCDetId((sign == '+') ? 1 : 2, stat, ring, cham, 0);
+  }
+}
 
 //------------------
 // Static variables
@@ -54,7 +90,24 @@ CSCTriggerPrimitivesBuilder::CSCTriggerPrimitivesBuilder(const edm::ParameterSet
 
   checkBadChambers_ = conf.getUntrackedParameter<bool>("checkBadChambers", true);
 
+  // Whether to run the chambers concurrently.
+  runParallel_ = conf.getUntrackedParameter<bool>("runParallel", false);
+
+  // Whether to run only the chambers with wire or comparator digis.
+  sparseDispatch_ = conf.getUntrackedParameter<bool>("sparseDispatch", false);
+
+  // Whether the region of interest includes the neighbours of its chambers.
+  roiValid_ = false;
+  roiNeighbours_ = conf.getUntrackedParameter<bool>("roiNeighbours", false);
+
+  // Whether to capture the inputs of the chambers for standalone replay.
+  std::string captureFile = conf.getUntrackedParameter<std::string>("captureFile", "");
+  if (!captureFile.empty())
+    capture_ = CSCChamberDigiCapture::open(captureFile,
+      smartME1aME1b ? CSCChamberDigiCapture::SMART_ME1A_ME1B : 0);
+
   // ORCA way of initializing boards.
+  tmbIndex_.assign(MAX_ENDCAPS*MAX_STATIONS*3*CSCDetId::maxChamberId(), -1);
   for (int endc = min_endcap; endc <= max_endcap; endc++)
   {
     for (int stat = min_station; stat <= max_station; stat++)
@@ -80,17 +133,74 @@ CSCTriggerPrimitivesBuilder::CSCTriggerPrimitivesBuilder(const edm::ParameterSet
               continue;
             }
             int ring = CSCTriggerNumbering::ringFromTriggerLabels(stat, cham);
+            int chid = CSCTriggerNumbering::chamberFromTriggerLabels(sect, subs, stat, cham);
+
+            TMBDescriptor info;
+            // 0th layer means whole chamber.
+            info.detid = CSCDetId(endc, stat, ring, chid, 0);
+            info.endcap = endc;
+            info.station = stat;
+            info.sector = sect;
+            info.subsector = subs;
+            info.trigChamber = cham;
+            info.ring = ring;
+            info.isME11 = (stat==1 && ring==1 && smartME1aME1b);
+            info.inGeometry = false;
+
             // When the motherboard is instantiated, it instantiates ALCT
             // and CLCT processors.
-            if (stat==1 && ring==1 && smartME1aME1b)
-              tmb_[endc-1][stat-1][sect-1][subs-1][cham-1] = new CSCMotherboardME11(endc, stat, sect, subs, cham, conf);
+            if (info.isME11)
+              tmb_.push_back(new CSCMotherboardME11(endc, stat, sect, subs, cham, conf));
             else
-              tmb_[endc-1][stat-1][sect-1][subs-1][cham-1] = new CSCMotherboard(endc, stat, sect, subs, cham, conf);
+              tmb_.push_back(new CSCMotherboard(endc, stat, sect, subs, cham, conf));
+            tmbInfo_.push_back(info);
+
+            int key = chamberKey(info.detid);
+            if (key >= 0) tmbIndex_[key] = tmb_.size() - 1;
           }
         }
       }
     }
   }
+  geometryFlagsValid_ = false;
+  geometryCacheId_ = 0;
+  badChamberBits_.assign(tmb_.size(), false);
+  readout_.resize(tmb_.size());
+  badChambersCacheId_ = 0;
+  runnableValid_ = false;
+  configCacheId_ = 0;
+  nConfigUpdates_ = 0;
+
+  // Whether to trace the boards of some chambers.  The trace of each
+  // chamber can be decoded with CSCTriggerTraceDump.
+  traced_.assign(tmb_.size(), false);
+  traceEvent_ = 0;
+  std::vector<std::string> traceChambers =
+    conf.getUntrackedParameter<std::vector<std::string> >("traceChambers",
+							  std::vector<std::string>());
+  if (!traceChambers.empty())
+  {
+    trace_ = CSCTriggerTrace::open(
+      conf.getUntrackedParameter<std::string>("traceFile", "csctrace.bin"));
+    for (unsigned int i = 0; i < traceChambers.size(); i++)
+    {
+      const CSCDetId id = chamberFromName(traceChambers[i]);
+      const int key = chamberKey(id);
+      if (key < 0 || tmbIndex_[key] < 0)
+      {
+        edm::LogWarning("L1CSCTPEmulatorSetupError")
+          << "+++ no TMB serves traced chamber " << traceChambers[i]
+          << "; ignoring it +++\n";
+        continue;
+      }
+      const int t = tmbIndex_[key];
+      if (tmbInfo_[t].isME11)
+        static_cast<CSCMotherboardME11*>(tmb_[t])->setTrace(trace_.get());
+      else
+        tmb_[t]->setTrace(trace_.get());
+      traced_[t] = true;
+    }
+  }
 
   // Get min and max BX to sort LCTs in MPC.
   m_minBX = conf.getParameter<int>("MinBX");
@@ -98,6 +208,25 @@ CSCTriggerPrimitivesBuilder::CSCTriggerPrimitivesBuilder(const edm::ParameterSet
 
   // Init MPC
   m_muonportcard = new CSCMuonPortCard(conf);
+
+  // List the (sub)sectors and BXs sorted by the MPC.
+  for (int bx = m_minBX; bx <= m_maxBX; ++bx)
+    for (int e = min_endcap; e <= max_endcap; ++e)
+      for (int st = min_station; st <= max_station; ++st)
+        for (int se = min_sector; se <= max_sector; ++se)
+        {
+          MPCSlice slice = {bx, e, st, se, 0};
+          if (st == 1)
+          {
+            for (int sub = 1; sub <= 2; ++sub)
+            {
+              slice.subsector = sub;
+              mpcSlices_.push_back(slice);
+            }
+          }
+          else mpcSlices_.push_back(slice);
+        }
+  mpcSorted_.resize(mpcSlices_.size());
 }
 
 //------------
@@ -105,23 +234,7 @@ CSCTriggerPrimitivesBuilder::CSCTriggerPrimitivesBuilder(const edm::ParameterSet
 //------------
 CSCTriggerPrimitivesBuilder::~CSCTriggerPrimitivesBuilder()
 {
-  for (int endc = min_endcap; endc <= max_endcap; endc++)
-  {
-    for (int stat = min_station; stat <= max_station; stat++)
-    {
-      int numsubs = ((stat == 1) ? max_subsector : 1);
-      for (int sect = min_sector; sect <= max_sector; sect++)
-      {
-        for (int subs = min_subsector; subs <= numsubs; subs++)
-        {
-          for (int cham = min_chamber; cham <= max_chamber; cham++)
-          {
-            delete tmb_[endc-1][stat-1][sect-1][subs-1][cham-1];
-          }
-        }
-      }
-    }
-  }
+  for (unsigned int i = 0; i < tmb_.size(); i++) delete tmb_[i];
   delete m_muonportcard;
 }
 
@@ -133,24 +246,155 @@ void CSCTriggerPrimitivesBuilder::setConfigParameters(const CSCDBL1TPParameters*
 {
   // Receives CSCDBL1TPParameters percolated down from ESProducer.
 
-  for (int endc = min_endcap; endc <= max_endcap; endc++)
+  for (unsigned int i = 0; i < tmb_.size(); i++) tmb_[i]->setConfigParameters(conf);
+  nConfigUpdates_++;
+}
+
+// Set configuration parameters obtained via EventSetup mechanism if the
+// record they come from changed since they were last applied.  The cache
+// identifier of an EventSetup record is never 0 once the record is filled.
+bool CSCTriggerPrimitivesBuilder::setConfigParameters(const CSCDBL1TPParameters* conf,
+						      unsigned long long cacheId)
+{
+  if (cacheId != 0 && cacheId == configCacheId_) return false;
+  setConfigParameters(conf);
+  configCacheId_ = cacheId;
+  return true;
+}
+
+// Dense index of a chamber used to look up its TMB.  ME1/a (ring 4) is
+// served by the ME1/1 TMB.
+int CSCTriggerPrimitivesBuilder::chamberKey(const CSCDetId& id)
+{
+  int endc = id.endcap();
+  int stat = id.station();
+  int ring = (id.ring() == 4) ? 1 : id.ring();
+  int cham = id.chamber();
+  if ((endc <= 0 || endc > MAX_ENDCAPS)  ||
+      (stat <= 0 || stat > MAX_STATIONS) ||
+      (ring <= 0 || ring > 3) ||
+      (cham <= 0 || cham > CSCDetId::maxChamberId())) return -1;
+  return (((endc-1)*MAX_STATIONS + stat-1)*3 + ring-1)*CSCDetId::maxChamberId() + cham-1;
+}
+
+// Flag the TMBs of chambers with at least one digi in the given (wire or
+// comparator) digi collection.
+template <class T>
+void CSCTriggerPrimitivesBuilder::markActiveChambers(const T* dc,
+						     std::vector<char>& active) const
+{
+  for (typename T::DigiRangeIterator it = dc->begin(); it != dc->end(); ++it)
   {
-    for (int stat = min_station; stat <= max_station; stat++)
+    if ((*it).second.first == (*it).second.second) continue;
+    int key = chamberKey((*it).first);
+    if (key < 0 || tmbIndex_[key] < 0)
     {
-      int numsubs = ((stat == 1) ? max_subsector : 1);
-      for (int sect = min_sector; sect <= max_sector; sect++)
-      {
-        for (int subs = min_subsector; subs <= numsubs; subs++)
-        {
-          for (int cham = min_chamber; cham <= max_chamber; cham++)
-          {
-            CSCMotherboard* tmb = tmb_[endc-1][stat-1][sect-1][subs-1][cham-1];
-            tmb->setConfigParameters(conf);
-          }
-        }
-      }
+      edm::LogWarning("L1CSCTPEmulatorWrongInput")
+        << "+++ digis found in CSC of illegal id " << (*it).first
+        << "; ignoring them +++\n";
+      continue;
     }
+    active[tmbIndex_[key]] = 1;
+  }
+}
+
+// Flag the TMBs of the chambers of the region of interest.  The neighbours
+// of a chamber are the previous and next chambers of its ring.
+void CSCTriggerPrimitivesBuilder::setRegionOfInterest(const std::vector<CSCDetId>& chambers)
+{
+  roi_.assign(tmb_.size(), 0);
+  for (unsigned int i = 0; i < chambers.size(); i++)
+  {
+    const CSCDetId& id = chambers[i];
+    const int key = chamberKey(id);
+    if (key < 0 || tmbIndex_[key] < 0) continue;
+    roi_[tmbIndex_[key]] = 1;
+    if (!roiNeighbours_) continue;
+
+    const int ring = (id.ring() == 4) ? 1 : id.ring();
+    const int n_chambers = (id.station() > 1 && ring == 1) ? 18 : 36;
+    for (int d = -1; d <= 1; d += 2)
+    {
+      const int cham = (id.chamber() - 1 + d + n_chambers) % n_chambers + 1;
+      const int nkey = chamberKey(CSCDetId(id.endcap(), id.station(), ring, cham, 0));
+      if (nkey >= 0 && tmbIndex_[nkey] >= 0) roi_[tmbIndex_[nkey]] = 1;
+    }
+  }
+  roiValid_ = true;
+}
+
+// Take a snapshot of the CSC geometry if the record it comes from changed.
+// The cache identifier of an EventSetup record is never 0 once the record
+// is filled.
+bool CSCTriggerPrimitivesBuilder::setGeometry(const CSCGeometry* geom,
+					      unsigned long long cacheId)
+{
+  if (geometryFlagsValid_ && cacheId != 0 && cacheId == geometryCacheId_)
+    return false;
+  updateGeometry(geom);
+  geometryCacheId_ = cacheId;
+  return true;
+}
+
+// Take the list of bad chambers if the record it comes from changed, and
+// turn it into a bitmap of the TMBs.  Note that the list usually includes
+// most of ME4/2 chambers; also, there's no ME1/a-1/b separation, it's
+// whole ME1/1.
+bool CSCTriggerPrimitivesBuilder::setBadChambers(const CSCBadChambers* badChambers,
+						 unsigned long long cacheId)
+{
+  if (!checkBadChambers_) return false;
+  if (cacheId != 0 && cacheId == badChambersCacheId_) return false;
+  for (unsigned int i = 0; i < tmbInfo_.size(); i++)
+    badChamberBits_[i] = badChambers->isInBadChamber(tmbInfo_[i].detid);
+  badChambersCacheId_ = cacheId;
+  runnableValid_ = false;
+  return true;
+}
+
+// Check which chambers exist in the CSC geometry and pass the geometry of
+// those that do on to their TMBs, so that no geometry lookups are needed
+// while running the emulation.  This is done whenever the geometry
+// changes.
+void CSCTriggerPrimitivesBuilder::updateGeometry(const CSCGeometry* geom)
+{
+  for (unsigned int i = 0; i < tmbInfo_.size(); i++)
+  {
+    TMBDescriptor& info = tmbInfo_[i];
+    info.geometry =
+      CSCChamberGeometryInfo::fromGeometry(geom, info.endcap, info.station,
+					   info.sector, info.subsector,
+					   info.trigChamber);
+    info.inGeometry = info.geometry.exists;
+    if (!info.inGeometry) continue;
+
+    if (info.isME11)
+      static_cast<CSCMotherboardME11*>(tmb_[i])->setChamberGeometry(info.geometry);
+    else
+      tmb_[i]->setChamberGeometry(info.geometry);
+  }
+  geometryFlagsValid_ = true;
+  runnableValid_ = false;
+}
+
+// Collect the TMBs which may run in any event.
+void CSCTriggerPrimitivesBuilder::updateRunnable()
+{
+  runnable_.clear();
+  for (unsigned int i = 0; i < tmb_.size(); i++)
+  {
+    const TMBDescriptor& info = tmbInfo_[i];
+    if (disableME42 && info.station==4 && info.ring==2) continue;
+
+    // Run processors only if chamber exists in geometry.
+    if (!info.inGeometry) continue;
+
+    // Skip chambers marked as bad.
+    if (badChamberBits_[i]) continue;
+
+    runnable_.push_back(i);
   }
+  runnableValid_ = true;
 }
 
 // Build anode, cathode, and correlated LCTs in each chamber and fill them
@@ -162,8 +406,7 @@ void CSCTriggerPrimitivesBuilder::setConfigParameters(const CSCDBL1TPParameters*
 // MPC processor sorts up to 18 LCTs from 9 TMBs and writes collections of
 // up to 3 best LCTs per (sub)sector into Event (to be used by the Sector
 // Receiver).
-void CSCTriggerPrimitivesBuilder::build(const CSCBadChambers* badChambers,
-					const CSCWireDigiCollection* wiredc,
+void CSCTriggerPrimitivesBuilder::build(const CSCWireDigiCollection* wiredc,
 					const CSCComparatorDigiCollection* compdc,
 					CSCALCTDigiCollection& oc_alct,
 					CSCCLCTDigiCollection& oc_clct,
@@ -171,252 +414,419 @@ void CSCTriggerPrimitivesBuilder::build(const CSCBadChambers* badChambers,
 					CSCCorrelatedLCTDigiCollection& oc_lct,
 					CSCCorrelatedLCTDigiCollection& oc_sorted_lct)
 {
-  // CSC geometry.
-  CSCTriggerGeomManager* theGeom = CSCTriggerGeometry::get();
+  if (!geometryFlagsValid_)
+    throw cms::Exception("LogicError")
+      << "CSCTriggerPrimitivesBuilder::build called before setGeometry\n";
+  if (!runnableValid_) updateRunnable();
+
+  // In the sparse mode, find the chambers having any digis; the others
+  // cannot produce any LCTs and are not run.
+  std::vector<char> active;
+  if (sparseDispatch_)
+  {
+    active.assign(tmb_.size(), 0);
+    markActiveChambers(wiredc, active);
+    markActiveChambers(compdc, active);
+  }
 
-  for (int endc = min_endcap; endc <= max_endcap; endc++)
+  // Collect the TMBs to be run in this event: all the runnable ones or, in
+  // the sparse mode, those of them with digis; if a region of interest is
+  // set, only those in it.
+  std::vector<unsigned int> tasks;
+  if (sparseDispatch_ || roiValid_)
   {
-    for (int stat = min_station; stat <= max_station; stat++)
+    for (unsigned int i = 0; i < runnable_.size(); i++)
     {
-      int numsubs = ((stat == 1) ? max_subsector : 1);
-      for (int sect = min_sector; sect <= max_sector; sect++)
-      {
-        for (int subs = min_subsector; subs <= numsubs; subs++)
+      const unsigned int t = runnable_[i];
+      if (sparseDispatch_ && !active[t]) continue;
+      if (roiValid_ && !roi_[t]) continue;
+      tasks.push_back(t);
+    }
+  }
+  else tasks = runnable_;
+
+  if (capture_) captureChambers(tasks, wiredc, compdc);
+
+  if (runParallel_ && tasks.size() > 1)
+  {
+    // Every TMB only touches its own state, so the chambers can be run
+    // concurrently.  Each chamber writes into its own staging collections,
+    // which are then merged in the order of the loop above; the output is
+    // thus identical to that of the sequential mode.
+    std::vector<ChamberOutput> staging(tasks.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, tasks.size(), 1),
+      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i)
+          runChamber(tasks[i], wiredc, compdc, staging[i].alct,
+                     staging[i].clct, staging[i].pretrig, staging[i].lct);
+      });
+    for (unsigned int i = 0; i < staging.size(); i++)
+    {
+      mergeCollection(staging[i].alct, oc_alct);
+      mergeCollection(staging[i].clct, oc_clct);
+      mergeCollection(staging[i].pretrig, oc_pretrig);
+      mergeCollection(staging[i].lct, oc_lct);
+    }
+  }
+  else
+  {
+    for (unsigned int i = 0; i < tasks.size(); i++)
+      runChamber(tasks[i], wiredc, compdc, oc_alct, oc_clct, oc_pretrig, oc_lct);
+  }
+
+  // run MPC simulation
+  if (!outputs_.mpcLCTs) return;
+  CSCTP_TIME_ALL(MPC_SORT);
+  m_muonportcard->loadDigis(oc_lct);
+
+  // The slices are independent once the LCTs are loaded; in the parallel
+  // mode they are sorted concurrently, each into its own buffer.
+  const CSCMuonPortCard* mpc = m_muonportcard;
+  if (runParallel_ && mpcSlices_.size() > 1)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, mpcSlices_.size()),
+      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i)
         {
-          for (int cham = min_chamber; cham <= max_chamber; cham++)
-          {
-            
-            int ring = CSCTriggerNumbering::ringFromTriggerLabels(stat, cham);
-            
-            if (disableME42 && stat==4 && ring==2) continue;
+          const MPCSlice& slice = mpcSlices_[i];
+          mpcSorted_[i] = mpc->sort(slice.endcap, slice.station, slice.sector,
+                                    slice.subsector, slice.bx);
+        }
+      });
+  }
+  else
+  {
+    for (unsigned int i = 0; i < mpcSlices_.size(); i++)
+    {
+      const MPCSlice& slice = mpcSlices_[i];
+      mpcSorted_[i] = mpc->sort(slice.endcap, slice.station, slice.sector,
+                                slice.subsector, slice.bx);
+    }
+  }
 
-            CSCMotherboard* tmb = tmb_[endc-1][stat-1][sect-1][subs-1][cham-1];
+  // Put the sorted LCTs into the output collection in the order of the
+  // slices.
+  for (unsigned int i = 0; i < mpcSorted_.size(); i++)
+  {
+    std::vector<csctf::TrackStub>::const_iterator itr = mpcSorted_[i].begin();
+    for (; itr != mpcSorted_[i].end(); itr++)
+    {
+      oc_sorted_lct.insertDigi(CSCDetId(itr->getDetId().rawId()), *(itr->getDigi()));
+      LogDebug("L1CSCTrigger")
+        << "MPC " << *(itr->getDigi()) << " found in ME"
+        << ((itr->endcap() == 1) ? "+" : "-") << itr->station() << "/"
+        << CSCDetId(itr->getDetId().rawId()).ring() << "/"
+        << CSCDetId(itr->getDetId().rawId()).chamber()
+        << " (sector " << itr->sector()
+        << " trig id. " << itr->cscid() << ")" << "\n";
+    }
+  }
+}
 
-            // Run processors only if chamber exists in geometry.
-            if (tmb == 0 || theGeom->chamber(endc, stat, sect, subs, cham) == 0) continue;
 
-            int chid = CSCTriggerNumbering::chamberFromTriggerLabels(sect, subs, stat, cham);
+// Write the digis of the chambers to be run to the capture file, as the
+// LCT processors will read them: all six layers and, for ME1/1, the layers
+// of ME1/a as well.
+void CSCTriggerPrimitivesBuilder::captureChambers(const std::vector<unsigned int>& tasks,
+						  const CSCWireDigiCollection* wiredc,
+						  const CSCComparatorDigiCollection* compdc)
+{
+  std::vector<CSCChamberDigiCapture::Record>& records = captureRecords_;
+  records.clear();
 
-            // 0th layer means whole chamber.
-            CSCDetId detid(endc, stat, ring, chid, 0);
+  CSCChamberDigiCapture::Record record = {CSCChamberDigiCapture::EVENT, 0, 0, 0, 0};
+  records.push_back(record);
+  unsigned int n_chambers = 0;
 
-            // Skip chambers marked as bad (usually includes most of ME4/2 chambers;
-            // also, there's no ME1/a-1/b separation, it's whole ME1/1)
-            if (checkBadChambers_ && badChambers->isInBadChamber(detid)) continue;
+  for (unsigned int i = 0; i < tasks.size(); i++)
+  {
+    const CSCDetId& detid = tmbInfo_[tasks[i]].detid;
+    const CSCChamberGeometryInfo& geometry = tmbInfo_[tasks[i]].geometry;
+    const unsigned int first = records.size();
+    record.type = CSCChamberDigiCapture::CHAMBER;
+    record.rawId = detid.rawId();
+    record.channel = geometry.numWireGroups;
+    record.comparator = geometry.numStrips;
+    for (int layer = 0; layer < CSCConstants::NUM_LAYERS; layer++)
+      record.comparator |= geometry.stagger[layer] << (8 + layer);
+    record.word = 0;
+    records.push_back(record);
+
+    const int n_rings = (detid.station() == 1 && detid.ring() == 1) ? 2 : 1;
+    for (int r = 0; r < n_rings; r++)
+    {
+      const int ring = (r == 0) ? detid.ring() : 4;
+      for (int layer = 1; layer <= 6; layer++)
+      {
+        CSCDetId id(detid.endcap(), detid.station(), ring, detid.chamber(), layer);
 
+        const CSCWireDigiCollection::Range rwired = wiredc->get(id);
+        for (CSCWireDigiCollection::const_iterator digi = rwired.first;
+             digi != rwired.second; ++digi)
+        {
+          record.type = CSCChamberDigiCapture::WIRE;
+          record.rawId = id.rawId();
+          record.channel = digi->getWireGroup();
+          record.comparator = 0;
+          record.word = digi->getTimeBinWord();
+          records.push_back(record);
+        }
 
-            // running upgraded ME1/1 TMBs (non-upgraded)
-            if (stat==1 && ring==1 && smartME1aME1b)
-            {
-              CSCMotherboardME11* tmb11 = static_cast<CSCMotherboardME11*>(tmb);
- 
-              //LogTrace("CSCTriggerPrimitivesBuilder")<<"CSCTriggerPrimitivesBuilder::build in E:"<<endc<<" S:"<<stat<<" R:"<<ring;
- 
-              tmb11->run(wiredc,compdc);
-              std::vector<CSCCorrelatedLCTDigi> lctV = tmb11->readoutLCTs1b();
-              std::vector<CSCCorrelatedLCTDigi> lctV1a = tmb11->readoutLCTs1a();
- 
-              std::vector<CSCALCTDigi> alctV1a, alctV = tmb11->alct->readoutALCTs();
-
-              std::vector<CSCCLCTDigi> clctV = tmb11->clct->readoutCLCTs();
-              std::vector<int> preTriggerBXs = tmb11->clct->preTriggerBXs();
-              std::vector<CSCCLCTDigi> clctV1a = tmb11->clct1a->readoutCLCTs();
-              std::vector<int> preTriggerBXs1a = tmb11->clct1a->preTriggerBXs();
-
-              // perform simple separation of ALCTs into 1/a and 1/b
-              // for 'smart' case. Some duplication occurs for WG [10,15]
-              std::vector<CSCALCTDigi> tmpV(alctV);
-              alctV.clear();
-              for (unsigned int al=0; al < tmpV.size(); al++)
-              {
-                if (tmpV[al].getKeyWG()<=15) alctV1a.push_back(tmpV[al]);
-                if (tmpV[al].getKeyWG()>=10) alctV.push_back(tmpV[al]);
-              }
-              //LogTrace("CSCTriggerPrimitivesBuilder")<<"CSCTriggerPrimitivesBuilder:: a="<<alctV.size()<<" c="<<clctV.size()<<" l="<<lctV.size()
-              //  <<"   1a: a="<<alctV1a.size()<<" c="<<clctV1a.size()<<" l="<<lctV1a.size();
- 
-              // ME1/b
-
-              if (!(lctV.empty()&&alctV.empty()&&clctV.empty())) {
-                LogTrace("L1CSCTrigger")
-                  << "CSCTriggerPrimitivesBuilder results in " <<detid; 
-              }
-
-              // Correlated LCTs.
-              if (!lctV.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << lctV.size() << " ME1b LCT digi"
-                  << ((lctV.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_lct.put(std::make_pair(lctV.begin(),lctV.end()), detid);
-              }
- 
-              // Anode LCTs.
-              if (!alctV.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << alctV.size() << " ME1b ALCT digi"
-                  << ((alctV.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_alct.put(std::make_pair(alctV.begin(),alctV.end()), detid);
-              }
- 
-              // Cathode LCTs.
-              if (!clctV.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << clctV.size() << " ME1b CLCT digi"
-                  << ((clctV.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_clct.put(std::make_pair(clctV.begin(),clctV.end()), detid);
-              }
-
-              // Cathode LCTs pretriggers
-              if (!preTriggerBXs.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << preTriggerBXs.size() << " CLCT pretrigger"
-                  << ((preTriggerBXs.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_pretrig.put(std::make_pair(preTriggerBXs.begin(),preTriggerBXs.end()), detid);
-              }            
-
-              // ME1/a
-
-              if (disableME1a) continue;
-
-              CSCDetId detid1a(endc, stat, 4, chid, 0);
-
-              if (!(lctV1a.empty()&&alctV1a.empty()&&clctV1a.empty())){
-                LogTrace("L1CSCTrigger") << "CSCTriggerPrimitivesBuilder results in " <<detid1a;
-              }
- 
-              // Correlated LCTs.
-              if (!lctV1a.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << lctV1a.size() << " ME1a LCT digi"
-                  << ((lctV1a.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_lct.put(std::make_pair(lctV1a.begin(),lctV1a.end()), detid1a);
-              }
- 
-              // Anode LCTs.
-              if (!alctV1a.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << alctV1a.size() << " ME1a ALCT digi"
-                  << ((alctV1a.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_alct.put(std::make_pair(alctV1a.begin(),alctV1a.end()), detid1a);
-              }
- 
-              // Cathode LCTs.
-              if (!clctV1a.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << clctV1a.size() << " ME1a CLCT digi"
-                  << ((clctV1a.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_clct.put(std::make_pair(clctV1a.begin(),clctV1a.end()), detid1a);
-              }
-              
-              // Cathode LCTs pretriggers
-              if (!preTriggerBXs1a.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << preTriggerBXs.size() << " CLCT pretrigger"
-                  << ((preTriggerBXs.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_pretrig.put(std::make_pair(preTriggerBXs.begin(),preTriggerBXs.end()), detid);
-              }
-            } // upgraded TMB
-
-            // running non-upgraded TMB
-            else
-            {
-              tmb->run(wiredc,compdc);
-
-              std::vector<CSCCorrelatedLCTDigi> lctV = tmb->readoutLCTs();
-              std::vector<CSCALCTDigi> alctV = tmb->alct->readoutALCTs();
-              std::vector<CSCCLCTDigi> clctV = tmb->clct->readoutCLCTs();
-              std::vector<int> preTriggerBXs = tmb->clct->preTriggerBXs();
-
-              if (!(alctV.empty() && clctV.empty() && lctV.empty())) {
-                LogTrace("L1CSCTrigger")
-                  << "CSCTriggerPrimitivesBuilder got results in " <<detid;
-              }
-
-              /*
-              // tmp kludge: tightening of ME1a LCTs
-              if (stat==1 && ring==1) {
-                std::vector<CSCCorrelatedLCTDigi> lctV11;
-                for (unsigned t=0;t<lctV.size();t++){
-                  if (lctV[t].getStrip() < 127) lctV11.push_back(lctV[t]);
-                  else if (lctV[t].getQuality() >= 14) lctV11.push_back(lctV[t]);
-                }
-                lctV = lctV11;
-              }
-              */
-
-              // Correlated LCTs.
-              if (!lctV.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << lctV.size() << " LCT digi"
-                  << ((lctV.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_lct.put(std::make_pair(lctV.begin(),lctV.end()), detid);
-              }
-
-              // Anode LCTs.
-              if (!alctV.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << alctV.size() << " ALCT digi"
-                  << ((alctV.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_alct.put(std::make_pair(alctV.begin(),alctV.end()), detid);
-              }
-
-              // Cathode LCTs.
-              if (!clctV.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << clctV.size() << " CLCT digi"
-                  << ((clctV.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_clct.put(std::make_pair(clctV.begin(),clctV.end()), detid);
-              }
-
-              // Cathode LCTs pretriggers
-              if (!preTriggerBXs.empty()) {
-                LogTrace("L1CSCTrigger")
-                  << "Put " << preTriggerBXs.size() << " CLCT pretrigger"
-                  << ((preTriggerBXs.size() > 1) ? "s " : " ") << "in collection\n";
-                oc_pretrig.put(std::make_pair(preTriggerBXs.begin(),preTriggerBXs.end()), detid);
-              }
-            } // non-upgraded TMB
-          }
+        const CSCComparatorDigiCollection::Range rcompd = compdc->get(id);
+        for (CSCComparatorDigiCollection::const_iterator digi = rcompd.first;
+             digi != rcompd.second; ++digi)
+        {
+          record.type = CSCChamberDigiCapture::COMPARATOR;
+          record.rawId = id.rawId();
+          record.channel = digi->getStrip();
+          record.comparator = digi->getComparator();
+          record.word = digi->getTimeBinWord();
+          records.push_back(record);
         }
       }
     }
+
+    // Chambers without digis are not written.
+    if (records.size() == first + 1) records.pop_back();
+    else
+    {
+      records[first].word = records.size() - first - 1;
+      n_chambers++;
+    }
   }
+  records[0].word = n_chambers;
+  capture_->write(records);
+}
 
-  // run MPC simulation
-  m_muonportcard->loadDigis(oc_lct);
 
-  std::vector<csctf::TrackStub> result;
-  for(int bx = m_minBX; bx <= m_maxBX; ++bx)
-    for(int e = min_endcap; e <= max_endcap; ++e)
-      for(int st = min_station; st <= max_station; ++st)
-        for(int se = min_sector; se <= max_sector; ++se)
-        {
-          if(st == 1)
-          {
-            std::vector<csctf::TrackStub> subs1, subs2;
-            subs1 = m_muonportcard->sort(e, st, se, 1, bx);
-            subs2 = m_muonportcard->sort(e, st, se, 2, bx);
-            result.insert(result.end(), subs1.begin(), subs1.end());
-            result.insert(result.end(), subs2.begin(), subs2.end());
-          }
-          else
-          {
-            std::vector<csctf::TrackStub> sector;
-            sector = m_muonportcard->sort(e, st, se, 0, bx);
-            result.insert(result.end(), sector.begin(), sector.end());
-          }
-        }
+void CSCTriggerPrimitivesBuilder::ReadoutBuffers::clear()
+{
+  alct.clear();
+  alct1a.clear();
+  clct.clear();
+  clct1a.clear();
+  lct.clear();
+  lct1a.clear();
+}
+
+// Run the TMB of a single chamber and put the LCTs it found into the given
+// collections.
+void CSCTriggerPrimitivesBuilder::runChamber(unsigned int i,
+					     const CSCWireDigiCollection* wiredc,
+					     const CSCComparatorDigiCollection* compdc,
+					     CSCALCTDigiCollection& oc_alct,
+					     CSCCLCTDigiCollection& oc_clct,
+					     CSCCLCTPreTriggerCollection& oc_pretrig,
+					     CSCCorrelatedLCTDigiCollection& oc_lct)
+{
+  CSCMotherboard* tmb = tmb_[i];
+  const CSCDetId& detid = tmbInfo_[i].detid;
+
+  if (traced_[i])
+    trace_->record(detid.rawId(), CSCTriggerTrace::BUILDER, CSCTriggerTrace::EVENT,
+                   0, 0, 0, traceEvent_);
+
+  // The read-out LCTs of this TMB are appended to its buffers; only the
+  // requested ones are read out, the others are left empty.
+  ReadoutBuffers& out = readout_[i];
+  out.clear();
+  const bool readoutLCTs = outputs_.lcts || outputs_.mpcLCTs;
 
-  std::vector<csctf::TrackStub>::const_iterator itr = result.begin();
-  for (; itr != result.end(); itr++)
+  // running upgraded ME1/1 TMBs (non-upgraded)
+  if (tmbInfo_[i].isME11)
   {
-    oc_sorted_lct.insertDigi(CSCDetId(itr->getDetId().rawId()), *(itr->getDigi()));
-    LogDebug("L1CSCTrigger")
-      << "MPC " << *(itr->getDigi()) << " found in ME"
-      << ((itr->endcap() == 1) ? "+" : "-") << itr->station() << "/"
-      << CSCDetId(itr->getDetId().rawId()).ring() << "/"
-      << CSCDetId(itr->getDetId().rawId()).chamber()
-      << " (sector " << itr->sector()
-      << " trig id. " << itr->cscid() << ")" << "\n";
-  }
+    CSCMotherboardME11* tmb11 = static_cast<CSCMotherboardME11*>(tmb);
+
+    //LogTrace("CSCTriggerPrimitivesBuilder")<<"CSCTriggerPrimitivesBuilder::build in E:"<<endc<<" S:"<<stat<<" R:"<<ring;
+
+    tmb11->run(wiredc,compdc);
+    std::vector<CSCCorrelatedLCTDigi>& lctV = out.lct;
+    std::vector<CSCCorrelatedLCTDigi>& lctV1a = out.lct1a;
+    if (readoutLCTs)
+    {
+      tmb11->readoutLCTs1b(lctV);
+      tmb11->readoutLCTs1a(lctV1a);
+    }
+
+    std::vector<CSCALCTDigi>& alctV = out.alct;
+    std::vector<CSCALCTDigi>& alctV1a = out.alct1a;
+    if (outputs_.alcts) tmb11->alct->readoutALCTs(alctV);
+
+    std::vector<CSCCLCTDigi>& clctV = out.clct;
+    std::vector<CSCCLCTDigi>& clctV1a = out.clct1a;
+    if (outputs_.clcts)
+    {
+      tmb11->clct->readoutCLCTs(clctV);
+      tmb11->clct1a->readoutCLCTs(clctV1a);
+    }
+    const std::vector<int>& preTriggerBXs = tmb11->clct->preTriggerBXs();
+    const std::vector<int>& preTriggerBXs1a = tmb11->clct1a->preTriggerBXs();
+
+    // perform simple separation of ALCTs into 1/a and 1/b
+    // for 'smart' case. Some duplication occurs for WG [10,15]
+    unsigned int n_alct1b = 0;
+    for (unsigned int al=0; al < alctV.size(); al++)
+    {
+      if (alctV[al].getKeyWG()<=15) alctV1a.push_back(alctV[al]);
+      if (alctV[al].getKeyWG()>=10) alctV[n_alct1b++] = alctV[al];
+    }
+    alctV.resize(n_alct1b);
+
+    CSCTP_COUNT(1, 1, ALCTS, alctV.size());
+    CSCTP_COUNT(1, 1, CLCTS, clctV.size());
+    CSCTP_COUNT(1, 1, LCTS, lctV.size());
+    CSCTP_COUNT(1, 4, ALCTS, alctV1a.size());
+    CSCTP_COUNT(1, 4, CLCTS, clctV1a.size());
+    CSCTP_COUNT(1, 4, LCTS, lctV1a.size());
+    //LogTrace("CSCTriggerPrimitivesBuilder")<<"CSCTriggerPrimitivesBuilder:: a="<<alctV.size()<<" c="<<clctV.size()<<" l="<<lctV.size()
+    //  <<"   1a: a="<<alctV1a.size()<<" c="<<clctV1a.size()<<" l="<<lctV1a.size();
+
+    // ME1/b
+
+    if (!(lctV.empty()&&alctV.empty()&&clctV.empty())) {
+      LogTrace("L1CSCTrigger")
+        << "CSCTriggerPrimitivesBuilder results in " <<detid; 
+    }
+
+    // Correlated LCTs.
+    if (!lctV.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << lctV.size() << " ME1b LCT digi"
+        << ((lctV.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_lct.put(std::make_pair(lctV.begin(),lctV.end()), detid);
+    }
+
+    // Anode LCTs.
+    if (!alctV.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << alctV.size() << " ME1b ALCT digi"
+        << ((alctV.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_alct.put(std::make_pair(alctV.begin(),alctV.end()), detid);
+    }
+
+    // Cathode LCTs.
+    if (!clctV.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << clctV.size() << " ME1b CLCT digi"
+        << ((clctV.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_clct.put(std::make_pair(clctV.begin(),clctV.end()), detid);
+    }
+
+    // Cathode LCTs pretriggers
+    if (outputs_.preTriggers && !preTriggerBXs.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << preTriggerBXs.size() << " CLCT pretrigger"
+        << ((preTriggerBXs.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_pretrig.put(std::make_pair(preTriggerBXs.begin(),preTriggerBXs.end()), detid);
+    }            
+
+    // ME1/a
+
+    if (disableME1a) return;
+
+    CSCDetId detid1a(detid.endcap(), detid.station(), 4, detid.chamber(), 0);
+
+    if (!(lctV1a.empty()&&alctV1a.empty()&&clctV1a.empty())){
+      LogTrace("L1CSCTrigger") << "CSCTriggerPrimitivesBuilder results in " <<detid1a;
+    }
+
+    // Correlated LCTs.
+    if (!lctV1a.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << lctV1a.size() << " ME1a LCT digi"
+        << ((lctV1a.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_lct.put(std::make_pair(lctV1a.begin(),lctV1a.end()), detid1a);
+    }
+
+    // Anode LCTs.
+    if (!alctV1a.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << alctV1a.size() << " ME1a ALCT digi"
+        << ((alctV1a.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_alct.put(std::make_pair(alctV1a.begin(),alctV1a.end()), detid1a);
+    }
+
+    // Cathode LCTs.
+    if (!clctV1a.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << clctV1a.size() << " ME1a CLCT digi"
+        << ((clctV1a.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_clct.put(std::make_pair(clctV1a.begin(),clctV1a.end()), detid1a);
+    }
+    
+    // Cathode LCTs pretriggers
+    if (outputs_.preTriggers && !preTriggerBXs1a.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << preTriggerBXs.size() << " CLCT pretrigger"
+        << ((preTriggerBXs.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_pretrig.put(std::make_pair(preTriggerBXs.begin(),preTriggerBXs.end()), detid);
+    }
+  } // upgraded TMB
+
+  // running non-upgraded TMB
+  else
+  {
+    tmb->run(wiredc,compdc);
+
+    std::vector<CSCCorrelatedLCTDigi>& lctV = out.lct;
+    std::vector<CSCALCTDigi>& alctV = out.alct;
+    std::vector<CSCCLCTDigi>& clctV = out.clct;
+    if (readoutLCTs) tmb->readoutLCTs(lctV);
+    if (outputs_.alcts) tmb->alct->readoutALCTs(alctV);
+    if (outputs_.clcts) tmb->clct->readoutCLCTs(clctV);
+    const std::vector<int>& preTriggerBXs = tmb->clct->preTriggerBXs();
+
+    CSCTP_COUNT(detid.station(), detid.ring(), ALCTS, alctV.size());
+    CSCTP_COUNT(detid.station(), detid.ring(), CLCTS, clctV.size());
+    CSCTP_COUNT(detid.station(), detid.ring(), LCTS, lctV.size());
+
+    if (!(alctV.empty() && clctV.empty() && lctV.empty())) {
+      LogTrace("L1CSCTrigger")
+        << "CSCTriggerPrimitivesBuilder got results in " <<detid;
+    }
+
+    /*
+    // tmp kludge: tightening of ME1a LCTs
+    if (detid.station()==1 && detid.ring()==1) {
+      std::vector<CSCCorrelatedLCTDigi> lctV11;
+      for (unsigned t=0;t<lctV.size();t++){
+        if (lctV[t].getStrip() < 127) lctV11.push_back(lctV[t]);
+        else if (lctV[t].getQuality() >= 14) lctV11.push_back(lctV[t]);
+      }
+      lctV = lctV11;
+    }
+    */
+
+    // Correlated LCTs.
+    if (!lctV.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << lctV.size() << " LCT digi"
+        << ((lctV.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_lct.put(std::make_pair(lctV.begin(),lctV.end()), detid);
+    }
+
+    // Anode LCTs.
+    if (!alctV.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << alctV.size() << " ALCT digi"
+        << ((alctV.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_alct.put(std::make_pair(alctV.begin(),alctV.end()), detid);
+    }
+
+    // Cathode LCTs.
+    if (!clctV.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << clctV.size() << " CLCT digi"
+        << ((clctV.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_clct.put(std::make_pair(clctV.begin(),clctV.end()), detid);
+    }
+
+    // Cathode LCTs pretriggers
+    if (outputs_.preTriggers && !preTriggerBXs.empty()) {
+      LogTrace("L1CSCTrigger")
+        << "Put " << preTriggerBXs.size() << " CLCT pretrigger"
+        << ((preTriggerBXs.size() > 1) ? "s " : " ") << "in collection\n";
+      oc_pretrig.put(std::make_pair(preTriggerBXs.begin(),preTriggerBXs.end()), detid);
+    }
+  } // non-upgraded TMB
 }
@@ -22,9 +22,18 @@
 #include <DataFormats/CSCDigi/interface/CSCCLCTDigiCollection.h>
 #include <DataFormats/CSCDigi/interface/CSCCorrelatedLCTDigiCollection.h>
 #include <DataFormats/CSCDigi/interface/CSCCLCTPreTriggerCollection.h>
+#include <DataFormats/L1CSCTrackFinder/interface/TrackStub.h>
+#include <DataFormats/MuonDetId/interface/CSCDetId.h>
 #include <FWCore/ParameterSet/interface/ParameterSet.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCChamberGeometryInfo.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCChamberDigiCapture.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerTrace.h>
+
+#include <memory>
+#include <vector>
 
 class CSCDBL1TPParameters;
+class CSCGeometry;
 class CSCMotherboard;
 class CSCMuonPortCard;
 
@@ -43,11 +52,60 @@ class CSCTriggerPrimitivesBuilder
   /** Sets configuration parameters obtained via EventSetup mechanism. */
   void setConfigParameters(const CSCDBL1TPParameters* conf);
 
+  /** Sets configuration parameters obtained via EventSetup mechanism only
+   *  if they changed since the last call, i.e., if the cache identifier of
+   *  the record they come from is different.  Returns true if the
+   *  parameters were applied to the boards. */
+  bool setConfigParameters(const CSCDBL1TPParameters* conf,
+			   unsigned long long cacheId);
+
+  /** Number of times the configuration parameters were applied to the
+   *  boards. */
+  unsigned int numConfigUpdates() const { return nConfigUpdates_; }
+
+  /** Takes a snapshot of the geometry of all chambers from the given CSC
+   *  geometry and hands it to the TMB processors, if the cache identifier
+   *  of the MuonGeometryRecord it comes from changed since the last call.
+   *  Returns true if the snapshot was taken.  Must be called before the
+   *  first build(). */
+  bool setGeometry(const CSCGeometry* geom, unsigned long long cacheId);
+
+  /** Takes the list of bad chambers, not to be run, if checkBadChambers is
+   *  set and the cache identifier of the CSCBadChambersRcd it comes from
+   *  changed since the last call.  Returns true if the list was taken. */
+  bool setBadChambers(const CSCBadChambers* badChambers,
+		      unsigned long long cacheId);
+
+  /** Sets the number of the event to be built, recorded in the trace of
+   *  the traced chambers. */
+  void setTraceEvent(unsigned int event) { traceEvent_ = event; }
+
+  /** Restricts the next builds to the TMBs of the given chambers (ME1/a
+   *  standing for ME1/1) and, if roiNeighbours is set, of their neighbours
+   *  in the same ring.  Illegal ids are ignored. */
+  void setRegionOfInterest(const std::vector<CSCDetId>& chambers);
+
+  /** Lets the next builds run all the chambers again. */
+  void clearRegionOfInterest() { roiValid_ = false; }
+
+  /** Output collections to be filled by build(); all of them by default.
+   *  The TMB LCTs are also read out if only the MPC ones are requested,
+   *  as the MPC input. */
+  struct Outputs {
+    Outputs() : alcts(true), clcts(true), preTriggers(true),
+		lcts(true), mpcLCTs(true) {}
+    bool alcts, clcts, preTriggers, lcts, mpcLCTs;
+  };
+
+  /** Sets the output collections to be filled by the next builds. */
+  void setOutputs(const Outputs& outputs) { outputs_ = outputs; }
+
   /** Build anode, cathode, and correlated LCTs in each chamber and fill
    *  them into output collections.  Select up to three best correlated LCTs
-   *  in each (sub)sector and put them into an output collection as well. */
-  void build(const CSCBadChambers* badChambers,
-	     const CSCWireDigiCollection* wiredc,
+   *  in each (sub)sector and put them into an output collection as well.
+   *  Collections not requested by setOutputs() are left empty, the MPC
+   *  being run only if its output is requested. */
+  void build(const CSCWireDigiCollection* wiredc,
 	     const CSCComparatorDigiCollection* compdc,
 	     CSCALCTDigiCollection& oc_alct, CSCCLCTDigiCollection& oc_clct,
              CSCCLCTPreTriggerCollection & oc_pretrig,
@@ -76,6 +134,34 @@ class CSCTriggerPrimitivesBuilder
   /// a flag whether to skip chambers from the bad chambers map
   bool checkBadChambers_;
 
+  /// a flag whether to run the TMB processors of different chambers, and
+  /// the MPC sorting of different sectors and BXs, concurrently
+  bool runParallel_;
+
+  /// a flag whether to run only the TMBs of chambers with digis
+  bool sparseDispatch_;
+
+  /// output collections to be filled
+  Outputs outputs_;
+
+  /// region of interest: whether it is set, whether it includes the
+  /// neighbours of the chambers given, and the flags of its TMBs, indexed
+  /// as tmb_
+  bool roiValid_;
+  bool roiNeighbours_;
+  std::vector<char> roi_;
+
+  /// capture file of the chamber inputs, if any, and the records of the
+  /// current event
+  std::shared_ptr<CSCChamberDigiCapture> capture_;
+  std::vector<CSCChamberDigiCapture::Record> captureRecords_;
+
+  /// trace of the decisions of the boards of selected chambers, if any,
+  /// the flags of the traced TMBs, indexed as tmb_, and the current event
+  std::shared_ptr<CSCTriggerTrace> trace_;
+  std::vector<bool> traced_;
+  unsigned int traceEvent_;
+
   /** SLHC: special configuration parameters for ME11 treatment. */
   bool smartME1aME1b, disableME1a;
 
@@ -84,12 +170,116 @@ class CSCTriggerPrimitivesBuilder
 
   int m_minBX, m_maxBX; // min and max BX to sort.
 
-  /** Pointers to TMB processors for all possible chambers. */
-  CSCMotherboard*
-    tmb_[MAX_ENDCAPS][MAX_STATIONS][MAX_SECTORS][MAX_SUBSECTORS][MAX_CHAMBERS];
+  /** Precomputed description of a TMB processor and of its chamber. */
+  struct TMBDescriptor {
+    CSCDetId detid;   // chamber id (0th layer)
+    int endcap, station, sector, subsector, trigChamber; // trigger labels
+    int ring;
+    bool isME11;      // upgraded ME1/1 TMB (CSCMotherboardME11)
+    bool inGeometry;  // chamber exists in CSC geometry
+    CSCChamberGeometryInfo geometry; // geometry snapshot of the chamber
+  };
+
+  /** TMB processors for all possible chambers, ordered by trigger labels
+   *  (endcap, station, sector, subsector, chamber), and their descriptors;
+   *  tmbInfo_[i] describes tmb_[i]. */
+  std::vector<CSCMotherboard*> tmb_;
+  std::vector<TMBDescriptor> tmbInfo_;
+
+  /** Index in tmb_ of the TMB serving a chamber, addressed by chamberKey();
+   *  -1 if there is no such TMB. */
+  std::vector<int> tmbIndex_;
+
+  /** Whether the geometry of the descriptors is filled. */
+  bool geometryFlagsValid_;
+
+  /** Cache identifier of the MuonGeometryRecord the geometry of the
+   *  descriptors was taken from; 0 if unknown. */
+  unsigned long long geometryCacheId_;
+
+  /** Bitmap of the chambers in the bad chambers map, indexed as tmb_, and
+   *  cache identifier of the CSCBadChambersRcd it was built from. */
+  std::vector<bool> badChamberBits_;
+  unsigned long long badChambersCacheId_;
+
+  /** Indices in tmb_ of the TMBs which may run: those of chambers that
+   *  exist in the geometry and are neither disabled nor bad.  Rebuilt
+   *  when the geometry or the bad chambers change. */
+  std::vector<unsigned int> runnable_;
+  bool runnableValid_;
+
+  /** Cache identifier of the CSCDBL1TPParametersRcd whose parameters were
+   *  last applied to the boards; 0 if none was applied yet. */
+  unsigned long long configCacheId_;
+
+  /** Number of times the configuration parameters were applied. */
+  unsigned int nConfigUpdates_;
 
   /** Pointer to MPC processor. */
   CSCMuonPortCard* m_muonportcard;
+
+  /** A (sub)sector and BX sorted by the MPC; subsector is 0 outside
+   *  station 1. */
+  struct MPCSlice {
+    int bx, endcap, station, sector, subsector;
+  };
+
+  /** All slices sorted by the MPC, in the order in which their LCTs go
+   *  into the output collection, and the LCTs sorted in each of them. */
+  std::vector<MPCSlice> mpcSlices_;
+  std::vector<std::vector<csctf::TrackStub> > mpcSorted_;
+
+  /** Buffers into which the LCTs read out from a TMB are appended before
+   *  being put into the output collections; there is one set per TMB, so
+   *  that TMBs run concurrently do not share them, and their capacity is
+   *  kept from event to event.  The *1a buffers are used by ME1/1 TMBs
+   *  for ME1/a. */
+  struct ReadoutBuffers {
+    std::vector<CSCALCTDigi> alct, alct1a;
+    std::vector<CSCCLCTDigi> clct, clct1a;
+    std::vector<CSCCorrelatedLCTDigi> lct, lct1a;
+    void clear();
+  };
+  std::vector<ReadoutBuffers> readout_;
+
+  /** Staging collections filled by a single chamber in the parallel mode;
+   *  merged into the output collections in the order of the chamber loop
+   *  once all chambers are done. */
+  struct ChamberOutput {
+    CSCALCTDigiCollection alct;
+    CSCCLCTDigiCollection clct;
+    CSCCLCTPreTriggerCollection pretrig;
+    CSCCorrelatedLCTDigiCollection lct;
+  };
+
+  /** Dense index of a chamber (ME1/a folded onto ME1/1) in tmbIndex_;
+   *  -1 for illegal ids. */
+  static int chamberKey(const CSCDetId& id);
+
+  /** Flags the TMBs of chambers having any digis in the given collection. */
+  template <class T>
+  void markActiveChambers(const T* dc, std::vector<char>& active) const;
+
+  /** Fill the geometry of the TMB descriptors and pass it on to the TMBs. */
+  void updateGeometry(const CSCGeometry* geom);
+
+  /** Fill the list of TMBs which may run. */
+  void updateRunnable();
+
+  /** Writes the wire and comparator digis of the given TMBs' chambers to
+   *  the capture file. */
+  void captureChambers(const std::vector<unsigned int>& tasks,
+		       const CSCWireDigiCollection* wiredc,
+		       const CSCComparatorDigiCollection* compdc);
+
+  /** Runs the i-th TMB processor and puts the anode, cathode and
+   *  correlated LCTs it found into the given collections. */
+  void runChamber(unsigned int i,
+		  const CSCWireDigiCollection* wiredc,
+		  const CSCComparatorDigiCollection* compdc,
+		  CSCALCTDigiCollection& oc_alct, CSCCLCTDigiCollection& oc_clct,
+		  CSCCLCTPreTriggerCollection& oc_pretrig,
+		  CSCCorrelatedLCTDigiCollection& oc_lct);
 };
 
 #endif
@@ -0,0 +1,116 @@
+//-----------------------------------------------------------------------------
+//
+//   Class: CSCTriggerPrimitivesStats
+//
+//   Description:
+//     Optional per-chamber-type counters and stage timing of the emulator;
+//     compiled only with CSCTP_INSTRUMENTATION.
+//
+//-----------------------------------------------------------------------------
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesStats.h>
+
+#ifdef CSCTP_INSTRUMENTATION
+
+#include "tbb/atomic.h"
+#include "tbb/enumerable_thread_specific.h"
+
+#include <iomanip>
+#include <sstream>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+  typedef tbb::enumerable_thread_specific<CSCTriggerPrimitivesStats::Block> Blocks;
+  Blocks blocks;
+  tbb::atomic<int> activeStreams;
+
+  const char* const chamberNames[CSCTriggerPrimitivesStats::NUM_CHAMBER_TYPES] = {
+    "ME1/a", "ME1/b", "ME1/2", "ME1/3", "ME2/1", "ME2/2", "ME3/1", "ME3/2",
+    "ME4/1", "ME4/2", "all"
+  };
+  const char* const counterNames[CSCTriggerPrimitivesStats::NUM_COUNTERS] = {
+    "digis", "pulses", "pretrig", "ptnSearch", "ghosts", "deadBx",
+    "ALCTs", "CLCTs", "LCTs"
+  };
+  const char* const stageNames[CSCTriggerPrimitivesStats::NUM_STAGES] = {
+    "readWireDigis", "readComparatorDigis", "pulseExtension", "preTrigger",
+    "patternDetection", "ghostCancellation", "lctSearch", "findLCTs",
+    "correlateLCTs", "MPC sort"
+  };
+}
+
+CSCTriggerPrimitivesStats::Block::Block() {
+  for (int t = 0; t < NUM_CHAMBER_TYPES; t++) {
+    for (int c = 0; c < NUM_COUNTERS; c++) counts[t][c] = 0;
+    for (int s = 0; s < NUM_STAGES; s++) cycles[t][s] = calls[t][s] = 0;
+  }
+}
+
+CSCTriggerPrimitivesStats::Block& CSCTriggerPrimitivesStats::local() {
+  return blocks.local();
+}
+
+unsigned long long CSCTriggerPrimitivesStats::cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  // No cycle counter: count nanoseconds instead.
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec*1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+void CSCTriggerPrimitivesStats::beginStream() {
+  ++activeStreams;
+}
+
+bool CSCTriggerPrimitivesStats::endStream() {
+  return --activeStreams == 0;
+}
+
+std::string CSCTriggerPrimitivesStats::summary() {
+  Block total;
+  for (Blocks::const_iterator b = blocks.begin(); b != blocks.end(); ++b) {
+    for (int t = 0; t < NUM_CHAMBER_TYPES; t++) {
+      for (int c = 0; c < NUM_COUNTERS; c++)
+	total.counts[t][c] += b->counts[t][c];
+      for (int s = 0; s < NUM_STAGES; s++) {
+	total.cycles[t][s] += b->cycles[t][s];
+	total.calls[t][s]  += b->calls[t][s];
+      }
+    }
+  }
+
+  std::ostringstream strm;
+  strm << "CSC trigger primitives emulator counters"
+       << " (stubs as read out; 0 for the collections not produced)\n"
+       << std::setw(6) << "";
+  for (int c = 0; c < NUM_COUNTERS; c++)
+    strm << std::setw(12) << counterNames[c];
+  strm << "\n";
+  for (int t = 0; t < NUM_CHAMBER_TYPES; t++) {
+    strm << std::setw(6) << chamberNames[t];
+    for (int c = 0; c < NUM_COUNTERS; c++)
+      strm << std::setw(12) << total.counts[t][c];
+    strm << "\n";
+  }
+
+  strm << "CSC trigger primitives emulator stage cycles (calls, cycles/call)\n";
+  for (int s = 0; s < NUM_STAGES; s++) {
+    for (int t = 0; t < NUM_CHAMBER_TYPES; t++) {
+      if (total.calls[t][s] == 0) continue;
+      strm << std::setw(20) << stageNames[s] << std::setw(6) << chamberNames[t]
+	   << std::setw(16) << total.cycles[t][s]
+	   << std::setw(12) << total.calls[t][s]
+	   << std::setw(10) << total.cycles[t][s]/total.calls[t][s] << "\n";
+    }
+  }
+  return strm.str();
+}
+
+#endif
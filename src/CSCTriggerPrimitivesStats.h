@@ -0,0 +1,117 @@
+#ifndef CSCTriggerPrimitives_CSCTriggerPrimitivesStats_h
+#define CSCTriggerPrimitives_CSCTriggerPrimitivesStats_h
+
+/** \class CSCTriggerPrimitivesStats
+ *
+ * Optional instrumentation of the hot path of the emulator: counters of
+ * the work done (digis read, pulses built, pre-triggers, pattern searches,
+ * ghosts cancelled, dead-time bx, stubs produced) and cycle counts of the
+ * main stages, per chamber type (ME1/a, ME1/b, ME1/2, ... ME4/2).
+ *
+ * Each thread accumulates into its own block; the blocks are summed and
+ * printed when the last producer stream ends.  Stages may nest: e.g. the
+ * CLCT pre-trigger time includes the pattern finder calls it makes.
+ *
+ * The instrumentation is compiled only if CSCTP_INSTRUMENTATION is
+ * defined, e.g. with
+ *   scram b USER_CXXFLAGS="-DCSCTP_INSTRUMENTATION"
+ * otherwise the CSCTP_* macros expand to nothing and this class does not
+ * exist.
+ *
+ */
+
+#ifdef CSCTP_INSTRUMENTATION
+
+#include <string>
+
+class CSCTriggerPrimitivesStats
+{
+ public:
+  /** Chamber types; ALL is used for the stages not done per chamber. */
+  enum ChamberType {ME1A, ME1B, ME12, ME13, ME21, ME22, ME31, ME32, ME41,
+		    ME42, ALL, NUM_CHAMBER_TYPES};
+
+  /** Counters.  ALCTS, CLCTS and LCTS count the stubs read out for the
+   *  output collections, so they stay 0 for a collection switched off
+   *  (see CSCTriggerPrimitivesBuilder::setOutputs()); the LCTs are still
+   *  counted when only the MPC ones are produced. */
+  enum Counter {DIGIS, PULSES, PRETRIGGERS, PATTERN_SEARCHES, GHOSTS,
+		DEAD_TIME_BX, ALCTS, CLCTS, LCTS, NUM_COUNTERS};
+
+  enum Stage {READ_WIRE_DIGIS, READ_COMPARATOR_DIGIS, PULSE_EXTENSION,
+	      PRE_TRIGGER, PATTERN_DETECTION, GHOST_CANCELLATION, LCT_SEARCH,
+	      FIND_LCTS, CORRELATE_LCTS, MPC_SORT, NUM_STAGES};
+
+  /** Counters and cycle counts of one thread. */
+  struct Block {
+    Block();
+    unsigned long long counts[NUM_CHAMBER_TYPES][NUM_COUNTERS];
+    unsigned long long cycles[NUM_CHAMBER_TYPES][NUM_STAGES];
+    unsigned long long calls[NUM_CHAMBER_TYPES][NUM_STAGES];
+  };
+
+  /** Block of the calling thread. */
+  static Block& local();
+
+  /** Chamber type of the given station and ring (4 for ME1/a). */
+  static ChamberType chamberType(const int station, const int ring) {
+    if (station == 1) return (ring == 4) ? ME1A : static_cast<ChamberType>(ring);
+    return static_cast<ChamberType>(ME21 + 2*(station - 2) + ring - 1);
+  }
+
+  /** Time stamp counter. */
+  static unsigned long long cycles();
+
+  /** Adds to a counter of the calling thread. */
+  static void count(const ChamberType type, const Counter counter,
+		    const unsigned long long n) {
+    local().counts[type][counter] += n;
+  }
+
+  /** Adds the cycles spent in its scope to a stage. */
+  class Timer {
+  public:
+    Timer(const ChamberType type, const Stage stage) :
+      type_(type), stage_(stage), start_(cycles()) {}
+    ~Timer() {
+      Block& block = local();
+      block.cycles[type_][stage_] += cycles() - start_;
+      block.calls[type_][stage_]++;
+    }
+  private:
+    ChamberType type_;
+    Stage stage_;
+    unsigned long long start_;
+  };
+
+  /** Registers a producer stream; its end is reported by endStream(). */
+  static void beginStream();
+
+  /** Returns true for the last stream to end. */
+  static bool endStream();
+
+  /** Summary of all threads, as a printable table. */
+  static std::string summary();
+};
+
+#define CSCTP_COUNT(station, ring, counter, n)				\
+  CSCTriggerPrimitivesStats::count(					\
+    CSCTriggerPrimitivesStats::chamberType(station, ring),		\
+    CSCTriggerPrimitivesStats::counter, n)
+#define CSCTP_TIME(station, ring, stage)				\
+  CSCTriggerPrimitivesStats::Timer cscTPTimer_##stage(			\
+    CSCTriggerPrimitivesStats::chamberType(station, ring),		\
+    CSCTriggerPrimitivesStats::stage)
+#define CSCTP_TIME_ALL(stage)						\
+  CSCTriggerPrimitivesStats::Timer cscTPTimer_##stage(			\
+    CSCTriggerPrimitivesStats::ALL, CSCTriggerPrimitivesStats::stage)
+
+#else
+
+#define CSCTP_COUNT(station, ring, counter, n)
+#define CSCTP_TIME(station, ring, stage)
+#define CSCTP_TIME_ALL(stage)
+
+#endif
+
+#endif
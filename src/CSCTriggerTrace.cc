@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+//
+//   Class: CSCTriggerTrace
+//
+//   Description:
+//     Per-thread ring buffers of fixed-size records of the decisions of
+//     the LCT processors and TMBs of selected chambers.
+//
+//-----------------------------------------------------------------------------
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerTrace.h>
+
+#include <FWCore/MessageLogger/interface/MessageLogger.h>
+#include <FWCore/Utilities/interface/Exception.h>
+
+const char CSCTriggerTrace::magic[8] = {'C','S','C','T','R','C','E','1'};
+
+std::shared_ptr<CSCTriggerTrace>
+CSCTriggerTrace::open(const std::string& fileName)
+{
+  std::shared_ptr<CSCTriggerTrace> trace =
+    std::dynamic_pointer_cast<CSCTriggerTrace>(
+      shared(fileName, [&]() -> CSCFlatRecordFile* {
+	  return new CSCTriggerTrace(fileName);
+	}));
+  if (!trace) {
+    throw cms::Exception("CSCTriggerTrace")
+      << "File " << fileName << " is already written as another kind of file\n";
+  }
+  return trace;
+}
+
+CSCTriggerTrace::~CSCTriggerTrace()
+{
+  bool ok = writeHeader(magic, sizeof(Record), RING_SIZE);
+
+  // A ring which has wrapped around starts at its next slot.
+  for (tbb::enumerable_thread_specific<Ring>::const_iterator ring = rings_.begin();
+       ring != rings_.end(); ++ring) {
+    const std::vector<Record>& records = ring->records;
+    if (records.empty()) continue;
+    const size_t first = (records.size() == RING_SIZE) ? ring->next : 0;
+    const Record start = {0, BUILDER, EVENT, 0, 0, 0, 0};
+    ok = ok && write(&start, sizeof(Record), 1);
+    ok = ok && write(&records[first], sizeof(Record), records.size() - first);
+    ok = ok && write(&records[0], sizeof(Record), first);
+  }
+  if (!close()) ok = false;
+  if (!ok) edm::LogError("L1CSCTPEmulatorTraceError")
+    << "+++ Error writing trace file " << fileName() << " +++\n";
+}
+
+void CSCTriggerTrace::record(const uint32_t rawId, const Source source,
+			     const RecordType type, const int bx,
+			     const int key, const int a, const unsigned int b)
+{
+  Ring& ring = rings_.local();
+  Record r;
+  r.rawId = rawId;
+  r.source = source;
+  r.type = type;
+  r.bx = bx;
+  r.key = key;
+  r.a = a;
+  r.b = b;
+  if (ring.records.size() < RING_SIZE) {
+    if (ring.records.empty()) ring.records.reserve(RING_SIZE);
+    ring.records.push_back(r);
+  }
+  else {
+    ring.records[ring.next] = r;
+    ring.next = (ring.next + 1) % RING_SIZE;
+  }
+}
+
+const CSCTriggerTrace::Record*
+CSCTriggerTrace::firstRecord(const void* data, size_t size)
+{
+  uint32_t ringSize;
+  return static_cast<const Record*>(
+    CSCFlatRecordFile::firstRecord(data, size, magic, sizeof(Record), ringSize));
+}
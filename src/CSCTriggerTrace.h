@@ -0,0 +1,111 @@
+#ifndef CSCTriggerPrimitives_CSCTriggerTrace_h
+#define CSCTriggerPrimitives_CSCTriggerTrace_h
+
+/** \class CSCTriggerTrace
+ *
+ * Binary trace of the decisions taken by the LCT processors and TMBs of
+ * selected chambers: pre-triggers, patterns found, ghosts cancelled, LCTs
+ * latched and ALCT-CLCT correlations.  It is meant for debugging a few
+ * chambers in a job running at production speed, where raising the
+ * verbosity of all the boards is not an option.
+ *
+ * Records are fixed-size and are appended to a ring buffer of the thread
+ * the board runs on, without any formatting or locking; when a ring is
+ * full, its oldest records are overwritten.  The rings are written to a
+ * file when the trace is destroyed, and decoded offline (see
+ * test/CSCTriggerTraceDump.cc).  The file is a header followed by the
+ * records of each ring, oldest first; each ring starts with an EVENT
+ * record of raw id 0.
+ *
+ * Before a traced chamber is run, the builder records an EVENT record for
+ * it; the following records of that chamber in the same ring belong to
+ * that event.
+ *
+ * One trace object is shared by all the builders writing to the same file
+ * (one per stream).  The header (see CSCFlatRecordFile) holds the magic
+ * "CSCTRCE1", sizeof(Record) and RING_SIZE.
+ *
+ */
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCFlatRecordFile.h>
+
+#include "tbb/enumerable_thread_specific.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+class CSCTriggerTrace : public CSCFlatRecordFile
+{
+ public:
+  typedef CSCFlatRecordFile::Header Header;
+
+  /** Board which made the record. */
+  enum Source {BUILDER = 0, ALCT = 1, CLCT = 2, TMB = 3};
+
+  /** Record types.  The meaning of key, a and b depends on the type:
+   *  EVENT:        b = event number.
+   *  PRETRIGGER:   key = key wire group or half-strip; for the CLCT, a =
+   *                pattern id and b = number of layers hit.
+   *  PATTERN_HIT:  key = key wire group or half-strip, a = pattern, b =
+   *                quality (ALCT) or number of layers hit (CLCT).
+   *  GHOST_CANCEL: key = key wire group cancelled, a = pattern type (0 for
+   *                accelerator, 1 for collision), b = key wire group of
+   *                the neighbour which cancelled it.
+   *  LATCH:        key = key wire group or half-strip of the LCT, a =
+   *                pattern, b = quality.
+   *  CORRELATION:  key = key wire group, a = key half-strip, b = quality
+   *                of the correlated LCT.
+   */
+  enum RecordType {EVENT = 0, PRETRIGGER = 1, PATTERN_HIT = 2,
+		   GHOST_CANCEL = 3, LATCH = 4, CORRELATION = 5};
+
+  /** One record; rawId is that of the chamber (ring 4 for the ME1/a CLCT
+   *  processor). */
+  struct Record {
+    uint32_t rawId;
+    uint8_t source;
+    uint8_t type;
+    int16_t bx;
+    uint16_t key;
+    uint16_t a;
+    uint32_t b;
+  };
+
+  /** Number of records kept per thread. */
+  enum {RING_SIZE = 1 << 16};
+
+  /** Returns the trace writing to the given file, creating it if it does
+   *  not exist yet.  Throws if the file cannot be opened. */
+  static std::shared_ptr<CSCTriggerTrace> open(const std::string& fileName);
+
+  /** Writes the rings to the file. */
+  ~CSCTriggerTrace();
+
+  /** Appends a record to the ring of the calling thread. */
+  void record(const uint32_t rawId, const Source source, const RecordType type,
+	      const int bx, const int key, const int a, const unsigned int b);
+
+  /** Checks the header at the beginning of a mapped file; returns the
+   *  first record, or 0 if the header is not valid. */
+  static const Record* firstRecord(const void* data, size_t size);
+
+  static const char magic[8];
+
+ private:
+  explicit CSCTriggerTrace(const std::string& fileName) :
+    CSCFlatRecordFile(fileName) {}
+
+  /** Records of one thread; next is the slot written next. */
+  struct Ring {
+    Ring() : next(0) {}
+    std::vector<Record> records;
+    size_t next;
+  };
+
+  tbb::enumerable_thread_specific<Ring> rings_;
+};
+
+#endif
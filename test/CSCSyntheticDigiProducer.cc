@@ -0,0 +1,86 @@
+//-------------------------------------------------
+//
+//   Class: CSCSyntheticDigiProducer
+//
+//   Description: Makes wire and comparator digis of synthetic occupancy
+//                in all CSC chambers, for self-contained tests of the
+//                trigger primitives emulator.
+//
+//--------------------------------------------------
+
+#include "CSCSyntheticDigiProducer.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/MuonDetId/interface/CSCDetId.h"
+#include "DataFormats/CSCDigi/interface/CSCWireDigiCollection.h"
+#include "DataFormats/CSCDigi/interface/CSCComparatorDigiCollection.h"
+
+#include <memory>
+
+namespace {
+
+  // Chamber types: station, ring, number of chambers, of wire groups and
+  // of half-strips (ME1/1 includes the 16 ganged ME1/a strips, which
+  // CSCSyntheticHits puts into ring 4).
+  struct ChamberType {
+    int station, ring, numChambers, numWireGroups, numHalfStrips;
+  };
+
+  const ChamberType chamberTypes[] = {
+    {1, 1, 36,  48, 160}, {1, 2, 36,  64, 160}, {1, 3, 36,  32, 128},
+    {2, 1, 18, 112, 160}, {2, 2, 36,  64, 160},
+    {3, 1, 18,  96, 160}, {3, 2, 36,  64, 160},
+    {4, 1, 18,  96, 160}, {4, 2, 36,  64, 160}
+  };
+
+  // Seed of one chamber in one event; a multiplicative step between the
+  // inputs keeps nearby events and chambers apart.
+  unsigned long long chamberSeed(const unsigned long long seed,
+				 const unsigned long long event,
+				 const unsigned int rawId) {
+    const unsigned long long a = 6364136223846793005ULL;
+    return ((seed*a + event)*a + rawId)*a + 1442695040888963407ULL;
+  }
+
+}
+
+CSCSyntheticDigiProducer::CSCSyntheticDigiProducer(const edm::ParameterSet& conf) {
+  config_.meanMuons = conf.getUntrackedParameter<double>("meanMuons", 0.05);
+  config_.neutronHits = conf.getUntrackedParameter<double>("neutronHits", 0.1);
+  config_.pileup = conf.getUntrackedParameter<double>("pileup", 50.);
+  config_.seed = conf.getUntrackedParameter<unsigned int>("seed", 1);
+
+  produces<CSCWireDigiCollection>("MuonCSCWireDigi");
+  produces<CSCComparatorDigiCollection>("MuonCSCComparatorDigi");
+}
+
+CSCSyntheticDigiProducer::~CSCSyntheticDigiProducer() {
+}
+
+void CSCSyntheticDigiProducer::produce(edm::Event& ev,
+				       const edm::EventSetup& setup) {
+  std::auto_ptr<CSCWireDigiCollection> wiredc(new CSCWireDigiCollection);
+  std::auto_ptr<CSCComparatorDigiCollection> compdc(new CSCComparatorDigiCollection);
+
+  const unsigned int n_types = sizeof(chamberTypes)/sizeof(chamberTypes[0]);
+  for (int endcap = 1; endcap <= 2; endcap++) {
+    for (unsigned int i_type = 0; i_type < n_types; i_type++) {
+      const ChamberType& type = chamberTypes[i_type];
+      for (int chamber = 1; chamber <= type.numChambers; chamber++) {
+	const CSCDetId id(endcap, type.station, type.ring, chamber, 0);
+	CSCSyntheticHits::Config config = config_;
+	config.numWireGroups = type.numWireGroups;
+	config.numHalfStrips = type.numHalfStrips;
+	config.seed = chamberSeed(config_.seed, ev.id().event(), id.rawId());
+	CSCSyntheticHits hits(config);
+	hits.generate();
+	hits.fillDigis(id, *wiredc, *compdc);
+      }
+    }
+  }
+
+  ev.put(wiredc, "MuonCSCWireDigi");
+  ev.put(compdc, "MuonCSCComparatorDigi");
+}
+
+DEFINE_FWK_MODULE(CSCSyntheticDigiProducer);
@@ -0,0 +1,41 @@
+#ifndef CSCTriggerPrimitives_CSCSyntheticDigiProducer_h
+#define CSCTriggerPrimitives_CSCSyntheticDigiProducer_h
+
+/** \class CSCSyntheticDigiProducer
+ *
+ * Test producer of wire and comparator digis for all the chambers of the
+ * CSC system, made by CSCSyntheticHits: muons crossing the chambers on top
+ * of neutron-induced hits.  It lets the emulator run in self-contained
+ * tests, without an input file or conditions.
+ *
+ * The hits of each chamber are seeded by the seed parameter, the event
+ * number and the chamber id, so that a given event is the same whatever
+ * the order in which events are processed.
+ *
+ */
+
+#include <FWCore/Framework/interface/Frameworkfwd.h>
+#include <FWCore/Framework/interface/EDProducer.h>
+#include <FWCore/Framework/interface/Event.h>
+#include <FWCore/Framework/interface/EventSetup.h>
+#include <FWCore/ParameterSet/interface/ParameterSet.h>
+
+#include "CSCSyntheticHits.h"
+
+class CSCSyntheticDigiProducer : public edm::EDProducer
+{
+ public:
+  /// Constructor
+  explicit CSCSyntheticDigiProducer(const edm::ParameterSet& conf);
+
+  /// Destructor
+  virtual ~CSCSyntheticDigiProducer();
+
+  /// Makes the digis of one event
+  virtual void produce(edm::Event& ev, const edm::EventSetup& setup);
+
+ private:
+  CSCSyntheticHits::Config config_; // occupancy common to all chambers
+};
+
+#endif
@@ -0,0 +1,238 @@
+/** \class CSCSyntheticHits
+ *
+ * Generator of synthetic chamber occupancy for standalone tests of the
+ * CSC trigger primitives emulator.  An event of one chamber is made of
+ * straight muon tracks crossing all six layers near a fixed bunch
+ * crossing, on top of neutron-induced hits: isolated single-layer wire
+ * and strip signals at random bunch crossings, whose number grows
+ * linearly with pileup.
+ *
+ * The hits can be handed to the test versions of run() of the LCT
+ * processors and the TMB as arrays of times, or to their normal run()
+ * as wire and comparator digi collections.  The strip staggering is the
+ * one the processors assume when not configured from the geometry
+ * (odd layers, counted as ly0-ly5, shifted by one half-strip).
+ *
+ * The generator does not depend on any random-number service: a given
+ * seed always gives the same sequence of events.
+ *
+ */
+
+#ifndef CSCTriggerPrimitives_CSCSyntheticHits_h
+#define CSCTriggerPrimitives_CSCSyntheticHits_h
+
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <DataFormats/MuonDetId/interface/CSCDetId.h>
+#include <DataFormats/CSCDigi/interface/CSCWireDigiCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCComparatorDigiCollection.h>
+#include <L1Trigger/CSCCommonTrigger/interface/CSCConstants.h>
+
+class CSCSyntheticHits
+{
+ public:
+  /** Parameters of the generated occupancy. */
+  struct Config
+  {
+    Config() : meanMuons(1.), neutronHits(0.1), pileup(0.),
+	       numWireGroups(112), numHalfStrips(160),
+	       muonBx(6), maxBx(12), layerEfficiency(0.95), seed(1) {}
+
+    /** Mean number of muons per chamber and event. */
+    double meanMuons;
+    /** Mean number of neutron hits per chamber and pileup interaction. */
+    double neutronHits;
+    /** Number of pileup interactions. */
+    double pileup;
+    /** Numbers of wire groups and half-strips of the chamber. */
+    int numWireGroups;
+    int numHalfStrips;
+    /** Bunch crossing of the muons, and upper bound (excluded) of the
+	bunch crossings of the neutron hits. */
+    int muonBx;
+    int maxBx;
+    /** Probability for a muon to leave a hit in a given layer. */
+    double layerEfficiency;
+    unsigned long long seed;
+  };
+
+  explicit CSCSyntheticHits(const Config& config) :
+    theConfig(config), theState(config.seed ? config.seed : 1), theNumMuons(0) {}
+
+  /** Generates the hits of a new event. */
+  void generate() {
+    theWireWords.clear();
+    theHalfStripWords.clear();
+
+    theNumMuons = poisson(theConfig.meanMuons);
+    for (unsigned int i_muon = 0; i_muon < theNumMuons; i_muon++) addMuon();
+
+    const unsigned int n_neutrons =
+      poisson(theConfig.neutronHits*theConfig.pileup);
+    for (unsigned int i_hit = 0; i_hit < n_neutrons; i_hit++) addNeutronHit();
+  }
+
+  /** Number of muons in the current event. */
+  unsigned int numMuons() const {return theNumMuons;}
+
+  /** Number of wire and half-strip hits in the current event. */
+  unsigned int numWireHits() const {return theWireWords.size();}
+  unsigned int numHalfStripHits() const {return theHalfStripWords.size();}
+
+  /** Fills the wire times, as taken by the test version of run() of the
+      anode LCT processor. */
+  void fillWireTimes(std::vector<int> wire[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES]) const {
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
+      for (int i_wire = 0; i_wire < CSCConstants::MAX_NUM_WIRES; i_wire++)
+	wire[i_layer][i_wire].clear();
+    for (HitMap::const_iterator hit = theWireWords.begin();
+	 hit != theWireWords.end(); ++hit)
+      addTimes(hit->second, wire[hit->first.first][hit->first.second]);
+  }
+
+  /** Fills the half-strip and di-strip times, as taken by the test version
+      of run() of the cathode LCT processor. */
+  void fillStripTimes(std::vector<int> halfstrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS],
+		      std::vector<int> distrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS]) const {
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+      for (int i_hstrip = 0; i_hstrip < CSCConstants::NUM_HALF_STRIPS; i_hstrip++) {
+	halfstrip[i_layer][i_hstrip].clear();
+	distrip[i_layer][i_hstrip].clear();
+      }
+    }
+    for (HitMap::const_iterator hit = theHalfStripWords.begin();
+	 hit != theHalfStripWords.end(); ++hit) {
+      const int i_layer = hit->first.first;
+      const int i_hstrip = hit->first.second;
+      addTimes(hit->second, halfstrip[i_layer][i_hstrip]);
+      addTimes(hit->second, distrip[i_layer][i_hstrip/4]);
+    }
+  }
+
+  /** Fills the wire and comparator digis of the current event in the
+      given chamber.  In ME1/1, comparators beyond strip 64 go to ME1/a
+      (ring 4), with strips counted from 1 again. */
+  void fillDigis(const CSCDetId& chamber,
+		 CSCWireDigiCollection& wiredc,
+		 CSCComparatorDigiCollection& compdc) const {
+    for (HitMap::const_iterator hit = theWireWords.begin();
+	 hit != theWireWords.end(); ++hit) {
+      CSCDetId layer(chamber.endcap(), chamber.station(), chamber.ring(),
+		     chamber.chamber(), hit->first.first+1);
+      wiredc.insertDigi(layer, CSCWireDigi(hit->first.second+1, hit->second));
+    }
+
+    const bool me11 = (chamber.station() == 1 && chamber.ring() == 1);
+    for (HitMap::const_iterator hit = theHalfStripWords.begin();
+	 hit != theHalfStripWords.end(); ++hit) {
+      const int i_layer = hit->first.first;
+      const int hstrip = hit->first.second - stagger(i_layer);
+      if (hstrip < 0) continue;
+      int strip = hstrip/2;
+      int ring = chamber.ring();
+      if (me11 && strip >= 64) {
+	strip -= 64;
+	ring = 4;
+      }
+      CSCDetId layer(chamber.endcap(), chamber.station(), ring,
+		     chamber.chamber(), i_layer+1);
+      compdc.insertDigi(layer, CSCComparatorDigi(strip+1, hstrip%2, hit->second));
+    }
+  }
+
+ private:
+  /** Time-bin words of the hit channels, keyed by (layer, channel). */
+  typedef std::map<std::pair<int, int>, unsigned int> HitMap;
+
+  /** Staggering of the layer, in half-strips. */
+  static int stagger(const int i_layer) {return ((i_layer+1)%2 == 0) ? 0 : 1;}
+
+  static void addTimes(const unsigned int tbin_word, std::vector<int>& times) {
+    for (int tbin = 0; tbin < 32; tbin++)
+      if ((tbin_word >> tbin) & 1) times.push_back(tbin);
+  }
+
+  void addMuon() {
+    const int key_wire = uniformInt(theConfig.numWireGroups);
+    const int key_hstrip = uniformInt(theConfig.numHalfStrips);
+    // Slopes per layer: a wire group at most over the chamber for wires,
+    // and up to the largest CLCT pattern bend for half-strips.
+    const double wire_slope = 0.4*(uniform() - 0.5);
+    const double hstrip_slope = 2.0*(uniform() - 0.5);
+    int bx = theConfig.muonBx;
+    const double jitter = uniform();
+    if (jitter < 0.05) bx--;
+    else if (jitter > 0.95) bx++;
+
+    // Key layer is ly2.
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+      if (uniform() >= theConfig.layerEfficiency) continue;
+      const int wire =
+	key_wire + static_cast<int>(floor(wire_slope*(i_layer - 2) + 0.5));
+      const int hstrip =
+	key_hstrip + static_cast<int>(floor(hstrip_slope*(i_layer - 2) + 0.5));
+      addHit(theWireWords, i_layer, wire, theConfig.numWireGroups, bx);
+      addHit(theHalfStripWords, i_layer, hstrip, theConfig.numHalfStrips, bx);
+    }
+  }
+
+  void addNeutronHit() {
+    const int i_layer = uniformInt(CSCConstants::NUM_LAYERS);
+    const int bx = uniformInt(theConfig.maxBx);
+    addHit(theWireWords, i_layer, uniformInt(theConfig.numWireGroups),
+	   theConfig.numWireGroups, bx);
+    addHit(theHalfStripWords, i_layer, uniformInt(theConfig.numHalfStrips),
+	   theConfig.numHalfStrips, bx);
+  }
+
+  static void addHit(HitMap& hits, const int i_layer, const int channel,
+		     const int n_channels, const int bx) {
+    if (channel < 0 || channel >= n_channels || bx < 0 || bx >= 32) return;
+    hits[std::make_pair(i_layer, channel)] |= (1u << bx);
+  }
+
+  /** xorshift64* generator. */
+  unsigned long long next() {
+    theState ^= theState >> 12;
+    theState ^= theState << 25;
+    theState ^= theState >> 27;
+    return theState * 2685821657736338717ULL;
+  }
+
+  /** Uniform in [0, 1). */
+  double uniform() {return (next() >> 11) * (1.0/9007199254740992.0);}
+
+  /** Uniform in [0, n). */
+  int uniformInt(const int n) {return static_cast<int>(uniform()*n);}
+
+  unsigned int poisson(const double mean) {
+    if (mean <= 0.) return 0;
+    // Knuth's method for the small means used here; a Gaussian
+    // approximation beyond.
+    if (mean > 100.) {
+      const double u1 = uniform() + 1.e-300, u2 = uniform();
+      const double g = sqrt(-2.*log(u1))*cos(2.*M_PI*u2);
+      const double n = floor(mean + sqrt(mean)*g + 0.5);
+      return n > 0. ? static_cast<unsigned int>(n) : 0;
+    }
+    const double limit = exp(-mean);
+    unsigned int n = 0;
+    double p = uniform();
+    while (p > limit) {
+      n++;
+      p *= uniform();
+    }
+    return n;
+  }
+
+  Config theConfig;
+  unsigned long long theState;
+  unsigned int theNumMuons;
+  HitMap theWireWords;
+  HitMap theHalfStripWords;
+};
+
+#endif
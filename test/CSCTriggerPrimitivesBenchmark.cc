@@ -0,0 +1,266 @@
+//-------------------------------------------------
+//
+//   Program: CSCTriggerPrimitivesBenchmark
+//
+//   Description: Standalone timing of the CSC trigger primitives
+//                emulator on synthetic chamber occupancy.  For each
+//                pileup value, runs the anode and cathode LCT
+//                processors and the TMB of a regular chamber on the
+//                same events, and the ME1/1 TMB on the equivalent digi
+//                collections, and reports the time spent per chamber
+//                by each of them.
+//
+//                Built with the instrumentation of the emulator, i.e.
+//                  scram b USER_CXXFLAGS="-DCSCTP_INSTRUMENTATION"
+//                it also reports the time per chamber of the pulse
+//                extension, pretrigger and pattern finding of the LCT
+//                processors, of the ghost cancellation of the ALCT
+//                processor (the CLCT one has none), and of the ALCT-CLCT
+//                correlation of the TMBs, as measured by the CSCTP_TIME
+//                scopes.  As in the summary of the instrumentation, the
+//                CLCT pretrigger includes the pattern finding it does.
+//
+//   Usage: CSCTriggerPrimitivesBenchmark [--events N] [--muons M]
+//                [--neutrons H] [--pileup P] [--seed S]
+//          Without --pileup, a range of pileup values is scanned.
+//
+//--------------------------------------------------
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCAnodeLCTProcessor.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCCathodeLCTProcessor.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCMotherboard.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCMotherboardME11.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesStats.h>
+
+#include "CSCSyntheticHits.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <vector>
+
+namespace {
+
+  double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1.e9 + ts.tv_nsec;
+  }
+
+  // Time arrays of one chamber; static since they are large.
+  std::vector<int> wire[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES];
+  std::vector<int> halfstrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
+  std::vector<int> distrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
+
+#ifdef CSCTP_INSTRUMENTATION
+  typedef CSCTriggerPrimitivesStats Stats;
+
+  // Adds the cycles spent by the calling thread in each stage since the
+  // last call, all chamber types together, and starts counting anew.
+  void takeStageCycles(double stage_cycles[Stats::NUM_STAGES]) {
+    Stats::Block& block = Stats::local();
+    for (int s = 0; s < Stats::NUM_STAGES; s++)
+      for (int t = 0; t < Stats::NUM_CHAMBER_TYPES; t++)
+	stage_cycles[s] += block.cycles[t][s];
+    block = Stats::Block();
+  }
+#endif
+
+  struct Result {
+    Result() : alct(0.), clct(0.), tmb(0.), me11(0.),
+	       n_alcts(0), n_clcts(0), n_lcts(0), n_me11_lcts(0),
+	       n_wire_hits(0), n_hstrip_hits(0) {
+#ifdef CSCTP_INSTRUMENTATION
+      ns_per_cycle = 0.;
+      for (int s = 0; s < Stats::NUM_STAGES; s++)
+	alct_stages[s] = clct_stages[s] = tmb_stages[s] = me11_stages[s] = 0.;
+#endif
+    }
+    double alct, clct, tmb, me11;
+    unsigned long n_alcts, n_clcts, n_lcts, n_me11_lcts;
+    unsigned long n_wire_hits, n_hstrip_hits;
+#ifdef CSCTP_INSTRUMENTATION
+    // Cycles per stage, of the standalone processors and TMBs.
+    double alct_stages[Stats::NUM_STAGES], clct_stages[Stats::NUM_STAGES];
+    double tmb_stages[Stats::NUM_STAGES], me11_stages[Stats::NUM_STAGES];
+    double ns_per_cycle;
+#endif
+  };
+
+  Result runBenchmark(const CSCSyntheticHits::Config& config, const int n_events) {
+    CSCAnodeLCTProcessor alct;
+    CSCCathodeLCTProcessor clct;
+    CSCMotherboard tmb;
+    CSCMotherboardME11 me11;
+    alct.setVerbosity(0);
+    clct.setVerbosity(0);
+    tmb.setVerbosity(0);
+    me11.setVerbosity(0);
+
+    // ME1/1: 48 wire groups, 64 strips in ME1/b and 16 ganged in ME1/a.
+    CSCSyntheticHits::Config config_me11 = config;
+    config_me11.numWireGroups = 48;
+    config_me11.numHalfStrips = 160;
+    CSCSyntheticHits hits(config);
+    CSCSyntheticHits hits_me11(config_me11);
+    // The digis go to the chamber the ME1/1 test TMB reads.
+    const CSCDetId me11_id = me11.alct->chamberId();
+
+    Result result;
+#ifdef CSCTP_INSTRUMENTATION
+    // The stages are timed in cycles: calibrate them against the wall
+    // time of the timed events.
+    double discarded[Stats::NUM_STAGES] = {0.};
+    unsigned long long c_start = 0;
+    double t_start = 0.;
+#endif
+    const int n_warmup = n_events/10 + 1;
+    for (int i_event = -n_warmup; i_event < n_events; i_event++) {
+      const bool timed = (i_event >= 0);
+#ifdef CSCTP_INSTRUMENTATION
+      if (i_event == 0) {
+	c_start = Stats::cycles();
+	t_start = now();
+      }
+      takeStageCycles(discarded);
+#endif
+
+      hits.generate();
+      hits.fillWireTimes(wire);
+      hits.fillStripTimes(halfstrip, distrip);
+
+      double t0 = now();
+      alct.clear();
+      alct.run(wire);
+      double t1 = now();
+#ifdef CSCTP_INSTRUMENTATION
+      takeStageCycles(timed ? result.alct_stages : discarded);
+#endif
+      clct.clear();
+      clct.run(halfstrip, distrip);
+      double t2 = now();
+#ifdef CSCTP_INSTRUMENTATION
+      takeStageCycles(timed ? result.clct_stages : discarded);
+#endif
+      tmb.run(wire, halfstrip, distrip);
+      double t3 = now();
+#ifdef CSCTP_INSTRUMENTATION
+      takeStageCycles(timed ? result.tmb_stages : discarded);
+#endif
+
+      hits_me11.generate();
+      CSCWireDigiCollection wiredc;
+      CSCComparatorDigiCollection compdc;
+      hits_me11.fillDigis(me11_id, wiredc, compdc);
+
+#ifdef CSCTP_INSTRUMENTATION
+      takeStageCycles(discarded);
+#endif
+      double t4 = now();
+      me11.run(&wiredc, &compdc);
+      double t5 = now();
+#ifdef CSCTP_INSTRUMENTATION
+      takeStageCycles(timed ? result.me11_stages : discarded);
+#endif
+
+      if (!timed) continue;
+      result.alct += t1 - t0;
+      result.clct += t2 - t1;
+      result.tmb  += t3 - t2;
+      result.me11 += t5 - t4;
+      result.n_alcts += alct.getALCTs().size();
+      result.n_clcts += clct.getCLCTs().size();
+      result.n_lcts  += tmb.getLCTs().size();
+      result.n_me11_lcts += me11.getLCTs1a().size() + me11.getLCTs1b().size();
+      result.n_wire_hits += hits.numWireHits();
+      result.n_hstrip_hits += hits.numHalfStripHits();
+    }
+#ifdef CSCTP_INSTRUMENTATION
+    const unsigned long long c_total = Stats::cycles() - c_start;
+    if (c_total > 0) result.ns_per_cycle = (now() - t_start)/c_total;
+#endif
+    return result;
+  }
+
+  void usage(const char* prog) {
+    fprintf(stderr,
+	    "Usage: %s [--events N] [--muons M] [--neutrons H] [--pileup P] [--seed S]\n",
+	    prog);
+  }
+
+}
+
+int main(int argc, char** argv) {
+  int n_events = 10000;
+  CSCSyntheticHits::Config config;
+  std::vector<double> pileups;
+
+  for (int i = 1; i < argc; i++) {
+    if (i+1 >= argc) {usage(argv[0]); return 1;}
+    if      (strcmp(argv[i], "--events") == 0)   n_events = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--muons") == 0)    config.meanMuons = atof(argv[++i]);
+    else if (strcmp(argv[i], "--neutrons") == 0) config.neutronHits = atof(argv[++i]);
+    else if (strcmp(argv[i], "--pileup") == 0)   pileups.push_back(atof(argv[++i]));
+    else if (strcmp(argv[i], "--seed") == 0)     config.seed = strtoull(argv[++i], 0, 10);
+    else {usage(argv[0]); return 1;}
+  }
+  if (n_events <= 0) {usage(argv[0]); return 1;}
+  if (pileups.empty()) {
+    const double scan[] = {0., 50., 140., 200.};
+    pileups.assign(scan, scan + sizeof(scan)/sizeof(scan[0]));
+  }
+
+  printf("%d events per point, %.2f muons and %.3f neutron hits per pileup"
+	 " interaction per chamber\n", n_events, config.meanMuons, config.neutronHits);
+  printf("%7s %8s %8s | %9s %9s %9s %9s | %6s %6s %6s %6s\n",
+	 "pileup", "wires", "hstrips",
+	 "ALCT[ns]", "CLCT[ns]", "TMB[ns]", "ME11[ns]",
+	 "ALCTs", "CLCTs", "LCTs", "ME11");
+  std::vector<Result> results;
+  for (unsigned int i_pu = 0; i_pu < pileups.size(); i_pu++) {
+    config.pileup = pileups[i_pu];
+    const Result r = runBenchmark(config, n_events);
+    results.push_back(r);
+    const double n = n_events;
+    printf("%7.0f %8.2f %8.2f | %9.0f %9.0f %9.0f %9.0f | %6.3f %6.3f %6.3f %6.3f\n",
+	   config.pileup, r.n_wire_hits/n, r.n_hstrip_hits/n,
+	   r.alct/n, r.clct/n, r.tmb/n, r.me11/n,
+	   r.n_alcts/n, r.n_clcts/n, r.n_lcts/n, r.n_me11_lcts/n);
+    // Without pileup every muon should make an LCT; none at all means a
+    // TMB did not see its hits and the timing is meaningless.
+    if (config.pileup == 0. && config.meanMuons > 0. &&
+	(r.n_lcts == 0 || r.n_me11_lcts == 0)) {
+      fprintf(stderr, "No %s LCTs found without pileup\n",
+	      (r.n_lcts == 0) ? "regular TMB" : "ME1/1 TMB");
+      return 1;
+    }
+  }
+
+#ifdef CSCTP_INSTRUMENTATION
+  printf("\nTime per chamber of the stages [ns]\n");
+  printf("%7s | %9s %9s | %9s %9s | %9s %9s | %9s | %9s %9s\n",
+	 "", "pulse", "", "pretrig", "", "pattern", "", "ghost", "corr", "");
+  printf("%7s | %9s %9s | %9s %9s | %9s %9s | %9s | %9s %9s\n",
+	 "pileup", "ALCT", "CLCT", "ALCT", "CLCT", "ALCT", "CLCT", "ALCT",
+	 "TMB", "ME11");
+  for (unsigned int i_pu = 0; i_pu < results.size(); i_pu++) {
+    const Result& r = results[i_pu];
+    const double f = r.ns_per_cycle/n_events;
+    printf("%7.0f | %9.0f %9.0f | %9.0f %9.0f | %9.0f %9.0f | %9.0f | %9.0f %9.0f\n",
+	   pileups[i_pu],
+	   r.alct_stages[Stats::PULSE_EXTENSION]*f,
+	   r.clct_stages[Stats::PULSE_EXTENSION]*f,
+	   r.alct_stages[Stats::PRE_TRIGGER]*f,
+	   r.clct_stages[Stats::PRE_TRIGGER]*f,
+	   r.alct_stages[Stats::PATTERN_DETECTION]*f,
+	   r.clct_stages[Stats::PATTERN_DETECTION]*f,
+	   r.alct_stages[Stats::GHOST_CANCELLATION]*f,
+	   r.tmb_stages[Stats::CORRELATE_LCTS]*f,
+	   r.me11_stages[Stats::CORRELATE_LCTS]*f);
+  }
+#else
+  printf("\nRebuild with -DCSCTP_INSTRUMENTATION for the time of each stage.\n");
+#endif
+  return 0;
+}
@@ -0,0 +1,344 @@
+//-------------------------------------------------
+//
+//   Class: CSCTriggerPrimitivesGoldenFile
+//
+//   Description: Writes the inputs and outputs of the trigger primitives
+//                emulator to a golden file, or compares them field by
+//                field to those of a golden file.
+//
+//--------------------------------------------------
+
+#include "CSCTriggerPrimitivesGoldenFile.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/MuonDetId/interface/CSCDetId.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstring>
+
+namespace {
+
+  // Golden file format: the magic string, then for each event its run
+  // and event numbers followed by the sections in SectionType order.
+  // Each section holds the number of chambers, their raw ids, their
+  // numbers of digis, the number of fields and the fields.
+  const char goldenMagic[8] = {'C','S','C','T','P','G','F','1'};
+
+  // Names of the sections and of the data fields of their digis.
+  const char* const sectionNames[CSCTriggerPrimitivesGoldenFile::NUM_SECTIONS] = {
+    "wire digi", "comparator digi", "ALCT", "CLCT", "CLCT pre-trigger",
+    "TMB LCT", "MPC LCT"
+  };
+
+  const char* const wireFields[] = {"wireGroup", "timeBinWord"};
+  const char* const comparatorFields[] = {"strip", "comparator", "timeBinWord"};
+  const char* const alctFields[] = {
+    "valid", "quality", "accelerator", "collisionB", "keyWG", "BX", "trknmb",
+    "fullBX"
+  };
+  const char* const clctFields[] = {
+    "valid", "quality", "pattern", "stripType", "bend", "strip", "CFEB", "BX",
+    "trknmb", "fullBX"
+  };
+  const char* const pretriggerFields[] = {"BX"};
+  const char* const lctFields[] = {
+    "trknmb", "valid", "quality", "keyWG", "strip", "pattern", "bend", "BX",
+    "MPCLink", "BX0", "syncErr", "cscID"
+  };
+
+  const char* const* const fieldNames[CSCTriggerPrimitivesGoldenFile::NUM_SECTIONS] = {
+    wireFields, comparatorFields, alctFields, clctFields, pretriggerFields,
+    lctFields, lctFields
+  };
+  const unsigned int numFields[CSCTriggerPrimitivesGoldenFile::NUM_SECTIONS] = {
+    sizeof(wireFields)/sizeof(wireFields[0]),
+    sizeof(comparatorFields)/sizeof(comparatorFields[0]),
+    sizeof(alctFields)/sizeof(alctFields[0]),
+    sizeof(clctFields)/sizeof(clctFields[0]),
+    sizeof(pretriggerFields)/sizeof(pretriggerFields[0]),
+    sizeof(lctFields)/sizeof(lctFields[0]),
+    sizeof(lctFields)/sizeof(lctFields[0])
+  };
+
+  // Data fields of each type of digi, in the order of the names above.
+  void packFields(const CSCWireDigi& digi, std::vector<int>& fields) {
+    fields.push_back(digi.getWireGroup());
+    fields.push_back(digi.getTimeBinWord());
+  }
+
+  void packFields(const CSCComparatorDigi& digi, std::vector<int>& fields) {
+    fields.push_back(digi.getStrip());
+    fields.push_back(digi.getComparator());
+    fields.push_back(digi.getTimeBinWord());
+  }
+
+  void packFields(const CSCALCTDigi& digi, std::vector<int>& fields) {
+    fields.push_back(digi.isValid());
+    fields.push_back(digi.getQuality());
+    fields.push_back(digi.getAccelerator());
+    fields.push_back(digi.getCollisionB());
+    fields.push_back(digi.getKeyWG());
+    fields.push_back(digi.getBX());
+    fields.push_back(digi.getTrknmb());
+    fields.push_back(digi.getFullBX());
+  }
+
+  void packFields(const CSCCLCTDigi& digi, std::vector<int>& fields) {
+    fields.push_back(digi.isValid());
+    fields.push_back(digi.getQuality());
+    fields.push_back(digi.getPattern());
+    fields.push_back(digi.getStripType());
+    fields.push_back(digi.getBend());
+    fields.push_back(digi.getStrip());
+    fields.push_back(digi.getCFEB());
+    fields.push_back(digi.getBX());
+    fields.push_back(digi.getTrknmb());
+    fields.push_back(digi.getFullBX());
+  }
+
+  void packFields(const CSCCLCTPreTrigger& digi, std::vector<int>& fields) {
+    fields.push_back(digi.getBX());
+  }
+
+  void packFields(const CSCCorrelatedLCTDigi& digi, std::vector<int>& fields) {
+    fields.push_back(digi.getTrknmb());
+    fields.push_back(digi.isValid());
+    fields.push_back(digi.getQuality());
+    fields.push_back(digi.getKeyWG());
+    fields.push_back(digi.getStrip());
+    fields.push_back(digi.getPattern());
+    fields.push_back(digi.getBend());
+    fields.push_back(digi.getBX());
+    fields.push_back(digi.getMPCLink());
+    fields.push_back(digi.getBX0());
+    fields.push_back(digi.getSyncErr());
+    fields.push_back(digi.getCSCID());
+  }
+
+  template <class T>
+  void writeArray(FILE* file, const std::vector<T>& v) {
+    const unsigned int n = v.size();
+    fwrite(&n, sizeof(n), 1, file);
+    if (n > 0) fwrite(&v[0], sizeof(T), n, file);
+  }
+
+  template <class T>
+  bool readArray(FILE* file, std::vector<T>& v) {
+    unsigned int n;
+    if (fread(&n, sizeof(n), 1, file) != 1) return false;
+    v.resize(n);
+    return n == 0 || fread(&v[0], sizeof(T), n, file) == n;
+  }
+}
+
+CSCTriggerPrimitivesGoldenFile::CSCTriggerPrimitivesGoldenFile(
+			     const edm::ParameterSet& conf) :
+  file_(0), eventsAnalyzed(0), ndigis(0) {
+  const std::string mode = conf.getUntrackedParameter<std::string>("mode");
+  if (mode != "write" && mode != "compare") {
+    throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+      << "Unknown mode '" << mode << "'; expected 'write' or 'compare'\n";
+  }
+  writeMode_ = (mode == "write");
+  fileName_ = conf.getUntrackedParameter<std::string>("fileName");
+
+  const std::string lctProducer =
+    conf.getUntrackedParameter<std::string>("CSCLCTProducer");
+  wireToken_ = consumes<CSCWireDigiCollection>(
+		 conf.getParameter<edm::InputTag>("CSCWireDigiProducer"));
+  compToken_ = consumes<CSCComparatorDigiCollection>(
+		 conf.getParameter<edm::InputTag>("CSCComparatorDigiProducer"));
+  alctToken_ = consumes<CSCALCTDigiCollection>(edm::InputTag(lctProducer));
+  clctToken_ = consumes<CSCCLCTDigiCollection>(edm::InputTag(lctProducer));
+  pretrigToken_ =
+    consumes<CSCCLCTPreTriggerCollection>(edm::InputTag(lctProducer));
+  lctToken_ =
+    consumes<CSCCorrelatedLCTDigiCollection>(edm::InputTag(lctProducer));
+  mpclctToken_ = consumes<CSCCorrelatedLCTDigiCollection>(
+		   edm::InputTag(lctProducer, "MPCSORTED"));
+}
+
+CSCTriggerPrimitivesGoldenFile::~CSCTriggerPrimitivesGoldenFile() {
+  if (file_) fclose(file_);
+}
+
+void CSCTriggerPrimitivesGoldenFile::beginJob() {
+  file_ = fopen(fileName_.c_str(), writeMode_ ? "wb" : "rb");
+  if (!file_) {
+    throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+      << "Cannot open golden file " << fileName_ << "\n";
+  }
+
+  if (writeMode_) {
+    fwrite(goldenMagic, sizeof(goldenMagic), 1, file_);
+    return;
+  }
+
+  char magic[sizeof(goldenMagic)];
+  if (fread(magic, sizeof(magic), 1, file_) != 1 ||
+      memcmp(magic, goldenMagic, sizeof(magic)) != 0) {
+    throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+      << fileName_ << " is not a golden file of this format\n";
+  }
+  EventKey key;
+  Record record;
+  while (readRecord(key, record)) golden_[key] = record;
+  fclose(file_);
+  file_ = 0;
+}
+
+void CSCTriggerPrimitivesGoldenFile::analyze(const edm::Event& ev,
+					     const edm::EventSetup& setup) {
+  ++eventsAnalyzed;
+
+  Record record;
+  fillRecord(ev, record);
+  const EventKey key(ev.id().run(), ev.id().event());
+
+  for (int i = 0; i < NUM_SECTIONS; i++)
+    ndigis += record.sections[i].fields.size()/numFields[i];
+
+  if (writeMode_) {
+    writeRecord(key, record);
+    return;
+  }
+
+  std::map<EventKey, Record>::iterator golden = golden_.find(key);
+  if (golden == golden_.end()) {
+    throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+      << "Event " << ev.id() << " is not in golden file " << fileName_ << "\n";
+  }
+  for (int i = 0; i < NUM_SECTIONS; i++) {
+    compareSection(ev, static_cast<SectionType>(i),
+		   record.sections[i], golden->second.sections[i]);
+  }
+  golden_.erase(golden);
+}
+
+void CSCTriggerPrimitivesGoldenFile::fillRecord(const edm::Event& ev,
+						Record& record) const {
+  fillSection(ev, WIRE, wireToken_, record);
+  fillSection(ev, COMPARATOR, compToken_, record);
+  fillSection(ev, ALCT, alctToken_, record);
+  fillSection(ev, CLCT, clctToken_, record);
+  fillSection(ev, PRETRIGGER, pretrigToken_, record);
+  fillSection(ev, LCT, lctToken_, record);
+  fillSection(ev, MPCLCT, mpclctToken_, record);
+}
+
+template <class T>
+void CSCTriggerPrimitivesGoldenFile::fillSection(const edm::Event& ev,
+						 const SectionType type,
+						 const edm::EDGetTokenT<T>& token,
+						 Record& record) const {
+  edm::Handle<T> digis;
+  ev.getByToken(token, digis);
+  if (!digis.isValid()) {
+    throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+      << "Missing " << sectionNames[type] << " collection in event "
+      << ev.id() << "\n";
+  }
+
+  Section& section = record.sections[type];
+  for (typename T::DigiRangeIterator det = digis->begin();
+       det != digis->end(); ++det) {
+    unsigned int n_digis = 0;
+    for (typename T::const_iterator digi = (*det).second.first;
+	 digi != (*det).second.second; ++digi, ++n_digis) {
+      packFields(*digi, section.fields);
+    }
+    section.ids.push_back((*det).first.rawId());
+    section.counts.push_back(n_digis);
+  }
+}
+
+void CSCTriggerPrimitivesGoldenFile::compareSection(const edm::Event& ev,
+						    const SectionType type,
+						    const Section& section,
+						    const Section& golden) const {
+  const char* what = sectionNames[type];
+  const unsigned int n_fields = numFields[type];
+
+  if (section.ids.size() != golden.ids.size()) {
+    throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+      << "Numbers of chambers with " << what << "s differ in event "
+      << ev.id() << ": " << section.ids.size() << " vs "
+      << golden.ids.size() << " in golden file\n";
+  }
+
+  unsigned int offset = 0;
+  for (unsigned int i_det = 0; i_det < section.ids.size(); i_det++) {
+    const CSCDetId id(section.ids[i_det]);
+    if (section.ids[i_det] != golden.ids[i_det]) {
+      throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+	<< what << " chambers differ in event " << ev.id() << ": " << id
+	<< " vs " << CSCDetId(golden.ids[i_det]) << " in golden file\n";
+    }
+    if (section.counts[i_det] != golden.counts[i_det]) {
+      throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+	<< "Numbers of " << what << "s differ in event " << ev.id()
+	<< " in chamber " << id << ": " << section.counts[i_det]
+	<< " vs " << golden.counts[i_det] << " in golden file\n";
+    }
+    for (unsigned int i = 0; i < section.counts[i_det]*n_fields; i++, offset++) {
+      if (section.fields[offset] != golden.fields[offset]) {
+	throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+	  << what << "s differ in event " << ev.id() << " in chamber " << id
+	  << ": " << what << " #" << i/n_fields + 1 << ", field "
+	  << fieldNames[type][i%n_fields] << " = " << section.fields[offset]
+	  << " vs " << golden.fields[offset] << " in golden file\n";
+      }
+    }
+  }
+}
+
+void CSCTriggerPrimitivesGoldenFile::writeRecord(const EventKey& key,
+						 const Record& record) {
+  fwrite(&key.first, sizeof(key.first), 1, file_);
+  fwrite(&key.second, sizeof(key.second), 1, file_);
+  for (int i = 0; i < NUM_SECTIONS; i++) {
+    writeArray(file_, record.sections[i].ids);
+    writeArray(file_, record.sections[i].counts);
+    writeArray(file_, record.sections[i].fields);
+  }
+  if (ferror(file_)) {
+    throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+      << "Error writing golden file " << fileName_ << "\n";
+  }
+}
+
+bool CSCTriggerPrimitivesGoldenFile::readRecord(EventKey& key, Record& record) {
+  if (fread(&key.first, sizeof(key.first), 1, file_) != 1) return false;
+  bool ok = (fread(&key.second, sizeof(key.second), 1, file_) == 1);
+  for (int i = 0; i < NUM_SECTIONS && ok; i++) {
+    ok = readArray(file_, record.sections[i].ids) &&
+         readArray(file_, record.sections[i].counts) &&
+         readArray(file_, record.sections[i].fields);
+  }
+  if (!ok) {
+    throw cms::Exception("CSCTriggerPrimitivesGoldenFile")
+      << "Golden file " << fileName_ << " is truncated\n";
+  }
+  return true;
+}
+
+void CSCTriggerPrimitivesGoldenFile::endJob() {
+  if (writeMode_) {
+    edm::LogInfo("CSCTriggerPrimitivesGoldenFile")
+      << "Wrote " << ndigis << " digis of " << eventsAnalyzed
+      << " events to golden file " << fileName_;
+    return;
+  }
+  if (!golden_.empty()) {
+    edm::LogWarning("CSCTriggerPrimitivesGoldenFile")
+      << golden_.size() << " events of golden file " << fileName_
+      << " were not analyzed";
+  }
+  edm::LogInfo("CSCTriggerPrimitivesGoldenFile")
+    << "Compared " << ndigis << " digis in " << eventsAnalyzed
+    << " events to golden file " << fileName_ << ": no differences found";
+}
+
+DEFINE_FWK_MODULE(CSCTriggerPrimitivesGoldenFile);
@@ -0,0 +1,116 @@
+#ifndef CSCTriggerPrimitives_CSCTriggerPrimitivesGoldenFile_h
+#define CSCTriggerPrimitives_CSCTriggerPrimitivesGoldenFile_h
+
+/** \class CSCTriggerPrimitivesGoldenFile
+ *
+ * Bit-exact regression test of the trigger primitives emulator.
+ *
+ * In "write" mode, the per-chamber inputs (wire and comparator digis) and
+ * all the outputs of the emulator (ALCTs, CLCTs, CLCT pre-trigger BXs, TMB
+ * LCTs and MPC-sorted LCTs) of every event are stored in a compact binary
+ * golden file, each digi as the list of its data fields.  The golden files
+ * are written by the frozen baseline copy of the emulator in
+ * test/baseline, CSCTriggerPrimitivesBaselineProducer.
+ *
+ * In "compare" mode, the golden file is read back and the inputs and
+ * outputs of each event are compared field by field to those of the
+ * emulator instance under test, which may run a different engine
+ * (bit-parallel kernels, concurrent chamber loop, sparse dispatch...).
+ * Events are matched by their id, so the order in which they are
+ * processed does not matter.  Throws on the first difference, naming the
+ * chamber, the digi and the field.
+ *
+ */
+
+#include <FWCore/Framework/interface/Frameworkfwd.h>
+#include <FWCore/Framework/interface/one/EDAnalyzer.h>
+#include <FWCore/Framework/interface/Event.h>
+#include <FWCore/Framework/interface/EventSetup.h>
+#include <FWCore/ParameterSet/interface/ParameterSet.h>
+#include <FWCore/Utilities/interface/InputTag.h>
+#include <FWCore/Utilities/interface/EDGetToken.h>
+#include <DataFormats/CSCDigi/interface/CSCWireDigiCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCComparatorDigiCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCALCTDigiCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCCLCTDigiCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCCLCTPreTriggerCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCCorrelatedLCTDigiCollection.h>
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CSCTriggerPrimitivesGoldenFile : public edm::one::EDAnalyzer<>
+{
+ public:
+  /// Constructor
+  explicit CSCTriggerPrimitivesGoldenFile(const edm::ParameterSet& conf);
+
+  /// Destructor
+  virtual ~CSCTriggerPrimitivesGoldenFile();
+
+  /// Opens the golden file; in compare mode, reads all of it
+  virtual void beginJob();
+
+  /// Writes or compares the inputs and outputs of one event
+  virtual void analyze(const edm::Event& event, const edm::EventSetup& setup);
+
+  /// Prints the summary
+  virtual void endJob();
+
+  /// Collections stored per event, in this order.
+  enum SectionType {WIRE, COMPARATOR, ALCT, CLCT, PRETRIGGER, LCT, MPCLCT,
+		    NUM_SECTIONS};
+
+ private:
+  /** Digis of one collection: for each chamber (or layer), its raw id and
+      number of digis, and the data fields of all the digis in a row. */
+  struct Section {
+    std::vector<unsigned int> ids;
+    std::vector<unsigned int> counts;
+    std::vector<int> fields;
+  };
+
+  /** All the sections of one event. */
+  struct Record {
+    Section sections[NUM_SECTIONS];
+  };
+
+  typedef std::pair<unsigned int, unsigned long long> EventKey; // run, event
+
+  /** Fills the record of the event from its collections. */
+  void fillRecord(const edm::Event& ev, Record& record) const;
+
+  /** Packs one collection into its section; throws if the collection
+      is missing in the event. */
+  template <class T>
+  void fillSection(const edm::Event& ev, const SectionType type,
+		   const edm::EDGetTokenT<T>& token, Record& record) const;
+
+  /** Compares one section to its golden copy. */
+  void compareSection(const edm::Event& ev, const SectionType type,
+		      const Section& section, const Section& golden) const;
+
+  void writeRecord(const EventKey& key, const Record& record);
+  bool readRecord(EventKey& key, Record& record);
+
+  bool writeMode_;          // write or compare
+  std::string fileName_;    // name of the golden file
+  edm::EDGetTokenT<CSCWireDigiCollection> wireToken_;
+  edm::EDGetTokenT<CSCComparatorDigiCollection> compToken_;
+  edm::EDGetTokenT<CSCALCTDigiCollection> alctToken_;
+  edm::EDGetTokenT<CSCCLCTDigiCollection> clctToken_;
+  edm::EDGetTokenT<CSCCLCTPreTriggerCollection> pretrigToken_;
+  edm::EDGetTokenT<CSCCorrelatedLCTDigiCollection> lctToken_;
+  edm::EDGetTokenT<CSCCorrelatedLCTDigiCollection> mpclctToken_;
+
+  FILE* file_;
+  std::map<EventKey, Record> golden_; // golden records, in compare mode
+
+  int eventsAnalyzed;       // event number
+  unsigned long ndigis;     // number of written or compared digis
+};
+
+#endif
@@ -0,0 +1,185 @@
+# Bit-exact regression test of the CSC trigger primitives emulator.
+#
+# First record the inputs and outputs of the baseline emulator, the frozen
+# copy in test/baseline of the code before its performance rewrites:
+#   cmsRun CSCTriggerPrimitivesGolden_cfg.py mode=write config=tmb07
+# then compare those of the emulator, run with one of its engines, to
+# them, field by field:
+#   cmsRun CSCTriggerPrimitivesGolden_cfg.py mode=compare config=tmb07 engine=sparse threads=4 streams=2
+#
+# config selects the board configuration, starting from the PostLS1
+# parameters:
+#   tmb07         - current hardware (TMB07 firmware, ganged ME1/a)
+#   mtcc          - MTCC firmware
+#   slhc          - upgrade ME1/1 and MPC, ME1/a still ganged
+#   smartME1aME1b - upgrade ME1/1 and MPC, unganged ME1/a (PostLS1 default)
+# readout selects the read-out windows:
+#   standard - those of the configuration
+#   full     - opened to all the bx they can be opened to (from bx 1 to 15
+#              for ALCTs and LCTs, to 14 for CLCTs), so that the found
+#              best and second LCTs are compared and not only those read
+#              out in time
+# engine selects the implementation under test in compare mode:
+#   reference   - serial chamber loop and original pattern finding
+#   bitParallel - bit-parallel ALCT and CLCT pattern finding
+#   parallel    - concurrent chamber loop (runParallel)
+#   sparse      - concurrent loop over the chambers having digis
+# threads and streams set the numbers of threads and streams of the job;
+# with more threads than streams, the chambers of an event are shared out.
+# source selects the input:
+#   synthetic - digis of all chambers made by CSCSyntheticDigiProducer on
+#               the ideal geometry; needs no input file nor global tag
+#               (default, used by runCSCTriggerPrimitivesGolden.sh)
+#   file      - simulated digis read from inputFiles, with the geometry
+#               of the global tag
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('mode', 'write', VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string, "write or compare")
+options.register('config', 'tmb07', VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string,
+                 "tmb07, mtcc, slhc or smartME1aME1b")
+options.register('readout', 'standard', VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string, "standard or full")
+options.register('engine', 'reference', VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string,
+                 "reference, bitParallel, parallel or sparse")
+options.register('threads', 1, VarParsing.multiplicity.singleton,
+                 VarParsing.varType.int, "number of threads")
+options.register('streams', 1, VarParsing.multiplicity.singleton,
+                 VarParsing.varType.int, "number of streams")
+options.register('goldenFile', '', VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string,
+                 "golden file (default: cscTPGolden_<config>_<readout>.bin)")
+options.register('source', 'synthetic', VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string, "synthetic or file")
+options.inputFiles = 'file:muminus_pt50_CMSSW_6_1_0_pre2.root'
+options.maxEvents = 20
+options.parseArguments()
+
+process = cms.Process("CSCTriggerPrimitivesGolden")
+
+if options.source == 'synthetic':
+    process.source = cms.Source("EmptySource")
+elif options.source == 'file':
+    process.source = cms.Source("PoolSource",
+        fileNames = cms.untracked.vstring(options.inputFiles)
+    )
+else:
+    raise Exception("unknown source " + options.source)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(options.streams)
+)
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+
+# es_source of ideal geometry
+# ===========================
+if options.source == 'synthetic':
+    process.load("Geometry.MuonCommonData.muonIdealGeometryXML_cfi")
+    process.load("Geometry.MuonNumbering.muonNumberingInitialization_cfi")
+    process.load("Geometry.CSCGeometryBuilder.cscGeometry_cfi")
+    process.CSCGeometryESModule.useDDD = True
+    process.CSCGeometryESModule.applyAlignment = False
+else:
+    process.load('Configuration.StandardSequences.GeometryDB_cff')
+    process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+    process.GlobalTag.globaltag = 'MC_61_V1::All'
+
+# Synthetic digis, under the label the emulator reads
+# ===================================================
+if options.source == 'synthetic':
+    process.simMuonCSCDigis = cms.EDProducer("CSCSyntheticDigiProducer",
+        meanMuons = cms.untracked.double(0.05),
+        neutronHits = cms.untracked.double(0.1),
+        pileup = cms.untracked.double(50.),
+        seed = cms.untracked.uint32(1)
+    )
+
+# CSC Trigger Primitives emulator
+# ===============================
+process.load("L1Trigger.CSCTriggerPrimitives.cscTriggerPrimitiveDigisPostLS1_cfi")
+tp = process.cscTriggerPrimitiveDigisPostLS1
+
+if options.config == 'tmb07':
+    tp.commonParam.isSLHC = False
+    tp.commonParam.smartME1aME1b = False
+    tp.commonParam.gangedME1a = True
+elif options.config == 'mtcc':
+    tp.commonParam.isTMB07 = False
+    tp.commonParam.isMTCC = True
+    tp.commonParam.isSLHC = False
+    tp.commonParam.smartME1aME1b = False
+    tp.commonParam.gangedME1a = True
+elif options.config == 'slhc':
+    tp.commonParam.gangedME1a = True
+elif options.config != 'smartME1aME1b':
+    raise Exception("unknown config " + options.config)
+
+# The earliest bx read out is early_tbins+1; an ALCT read-out window is at
+# most 15 bx wide, and a CLCT one is made even.
+if options.readout == 'full':
+    for pset in (tp.alctParamOldMC, tp.alctParamMTCC, tp.alctParam07, tp.alctSLHC):
+        pset.alctEarlyTbins = cms.untracked.int32(0)
+        pset.alctL1aWindowWidth = cms.uint32(15)
+    for pset in (tp.tmbParam, tp.tmbSLHC):
+        pset.tmbEarlyTbins = cms.untracked.int32(0)
+        pset.tmbL1aWindowSize = cms.uint32(15)
+        pset.tmbReadoutEarliest2 = cms.untracked.bool(False)
+elif options.readout != 'standard':
+    raise Exception("unknown readout " + options.readout)
+
+if options.mode == 'write':
+    # The baseline emulator, with the same parameters.
+    process.cscTriggerPrimitiveDigisBaseline = cms.EDProducer(
+        "CSCTriggerPrimitivesBaselineProducer", **tp.parameters_())
+    emulator = process.cscTriggerPrimitiveDigisBaseline
+elif options.mode == 'compare':
+    # All the collections are compared, so all must be made.
+    tp.produceALCTs = True
+    tp.produceCLCTs = True
+    tp.producePreTriggers = True
+    tp.produceLCTs = True
+    tp.produceMPCLCTs = True
+    if options.engine == 'bitParallel':
+        for pset in (tp.alctParam07, tp.alctSLHC):
+            pset.alctBitParallelPatterns = True
+        for pset in (tp.clctParam07, tp.clctSLHC):
+            pset.clctBitParallelPatterns = True
+    elif options.engine == 'parallel':
+        tp.runParallel = True
+    elif options.engine == 'sparse':
+        tp.runParallel = True
+        tp.sparseDispatch = True
+    elif options.engine != 'reference':
+        raise Exception("unknown engine " + options.engine)
+    emulator = tp
+else:
+    raise Exception("unknown mode " + options.mode)
+
+goldenFile = options.goldenFile or \
+    'cscTPGolden_%s_%s.bin' % (options.config, options.readout)
+
+process.golden = cms.EDAnalyzer("CSCTriggerPrimitivesGoldenFile",
+    mode = cms.untracked.string(options.mode),
+    fileName = cms.untracked.string(goldenFile),
+    CSCLCTProducer = cms.untracked.string(emulator.label_()),
+    CSCWireDigiProducer = tp.CSCWireDigiProducer,
+    CSCComparatorDigiProducer = tp.CSCComparatorDigiProducer
+)
+
+# Scheduler path
+# ==============
+if options.source == 'synthetic':
+    process.p = cms.Path(process.simMuonCSCDigis * emulator * process.golden)
+else:
+    process.p = cms.Path(emulator * process.golden)
@@ -18,6 +18,10 @@ process.MessageLogger = cms.Service("MessageLogger",
     destinations = cms.untracked.vstring("log", "debug", "errors"),
     statistics = cms.untracked.vstring("stat"),
     # No constraint on log.txt content...
+    # At the end of each stream, log.txt gets the number of times the
+    # emulator applied the configuration parameters (L1CSCTrigger
+    # category); it stays at 1 as long as the parameters IOV does not
+    # change.
     log = cms.untracked.PSet(
         extension = cms.untracked.string(".txt"),
         lineLength = cms.untracked.int32(132),
@@ -0,0 +1,305 @@
+//-------------------------------------------------
+//
+//   Program: CSCTriggerPrimitivesReplay
+//
+//   Description: Standalone replay of chamber inputs captured by the
+//                emulator (captureFile parameter of the producer).  The
+//                capture file is memory-mapped and the wire and
+//                comparator digis of each chamber are fed to a TMB,
+//                without the framework event loop, to profile and tune
+//                the LCT processors and TMBs on real data.
+//
+//                Each chamber is run by a TMB of its own, made from the
+//                captured chamber id with the emulator parameters of the
+//                given configuration file and the captured chamber
+//                geometry; ME1/1 is run by the ME1/1 TMB if the inputs
+//                were captured with smartME1aME1b.  The digis are
+//                decoded into the wire and half-strip times as in the
+//                emulator and passed to the run() functions taking them.
+//
+//   Usage: CSCTriggerPrimitivesReplay <capture file> <config file>
+//                [--repeat N] [--stage alct|clct|tmb]
+//          where the configuration file defines the emulator parameters
+//          as process.emulator, see CSCTriggerPrimitivesReplay_cfg.py.
+//
+//--------------------------------------------------
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCAnodeLCTProcessor.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCCathodeLCTProcessor.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCMotherboard.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCMotherboardME11.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCChamberDigiCapture.h>
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCChamberGeometryInfo.h>
+
+#include <DataFormats/MuonDetId/interface/CSCDetId.h>
+#include <DataFormats/MuonDetId/interface/CSCTriggerNumbering.h>
+#include <FWCore/ParameterSet/interface/ParameterSet.h>
+#include <FWCore/PythonParameterSet/interface/MakeParameterSets.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+  double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1.e9 + ts.tv_nsec;
+  }
+
+  enum Stage {STAGE_ALCT, STAGE_CLCT, STAGE_TMB};
+
+  struct Totals {
+    Totals() : events(0), chambers(0), digis(0), stubs(0), time(0.) {}
+    unsigned long events, chambers, digis, stubs;
+    double time;
+  };
+
+  // Time arrays of one chamber; static since they are large.
+  std::vector<int> wire[CSCConstants::NUM_LAYERS][CSCConstants::MAX_NUM_WIRES];
+  std::vector<int> halfstrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
+  std::vector<int> distrip[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
+  std::vector<int> halfstrip1a[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
+  std::vector<int> distrip1a[CSCConstants::NUM_LAYERS][CSCConstants::NUM_HALF_STRIPS];
+
+  // Digis of one chamber, per layer; the ME1/a comparator digis are kept
+  // apart for the ME1/1 TMB.
+  std::vector<CSCWireDigi> wireDigis[CSCConstants::NUM_LAYERS];
+  std::vector<CSCComparatorDigi> compDigis[CSCConstants::NUM_LAYERS];
+  std::vector<CSCComparatorDigi> compDigis1a[CSCConstants::NUM_LAYERS];
+
+  // Emulator settings the digis are sorted out with.
+  struct Settings {
+    bool smartME1aME1b, disableME1a;
+  };
+
+  // TMBs made so far, by chamber raw id.
+  typedef std::map<uint32_t, CSCMotherboard*> Boards;
+
+  // Returns the TMB of the chamber of the given CHAMBER record, making it
+  // if needed, as CSCTriggerPrimitivesBuilder does.
+  CSCMotherboard* board(const CSCChamberDigiCapture::Record& chamber,
+			const Settings& settings, const edm::ParameterSet& conf,
+			Boards& boards) {
+    CSCMotherboard*& tmb = boards[chamber.rawId];
+    if (tmb) return tmb;
+
+    const CSCDetId id(chamber.rawId);
+    const int sector = CSCTriggerNumbering::triggerSectorFromLabels(id);
+    const int subsector = CSCTriggerNumbering::triggerSubSectorFromLabels(id);
+    const int cscid = CSCTriggerNumbering::triggerCscIdFromLabels(id);
+    CSCChamberGeometryInfo geometry;
+    geometry.exists = true;
+    geometry.numWireGroups = chamber.numWireGroups();
+    geometry.numStrips = chamber.numStrips();
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++)
+      geometry.stagger[i_layer] = chamber.stagger(i_layer);
+
+    if (settings.smartME1aME1b && id.station() == 1 && id.ring() == 1) {
+      CSCMotherboardME11* tmb11 =
+	new CSCMotherboardME11(id.endcap(), id.station(), sector, subsector,
+			       cscid, conf);
+      tmb11->setChamberGeometry(geometry);
+      tmb11->setVerbosity(0);
+      tmb = tmb11;
+    }
+    else {
+      tmb = new CSCMotherboard(id.endcap(), id.station(), sector, subsector,
+			       cscid, conf);
+      tmb->setChamberGeometry(geometry);
+      tmb->setVerbosity(0);
+    }
+    return tmb;
+  }
+
+  // Sorts the digis of one chamber out per layer, as the LCT processors
+  // read them from the digi collections: ME1/a digis go to the ME1/a
+  // processor of the ME1/1 TMB or, with ganged ME1/a, to the ME1/1 CLCT
+  // processor as strips 65-80.
+  void fillDigis(const CSCChamberDigiCapture::Record* digis,
+		 const unsigned int n_digis, const bool me11,
+		 const Settings& settings) {
+    for (int i_layer = 0; i_layer < CSCConstants::NUM_LAYERS; i_layer++) {
+      wireDigis[i_layer].clear();
+      compDigis[i_layer].clear();
+      compDigis1a[i_layer].clear();
+    }
+    for (unsigned int i = 0; i < n_digis; i++) {
+      const CSCChamberDigiCapture::Record& digi = digis[i];
+      const CSCDetId id(digi.rawId);
+      const int i_layer = id.layer() - 1;
+      const bool me1a = (id.station() == 1 && id.ring() == 4);
+      if (me1a && settings.disableME1a) continue;
+      if (digi.type == CSCChamberDigiCapture::WIRE) {
+	wireDigis[i_layer].push_back(CSCWireDigi(digi.channel, digi.word));
+      }
+      else if (digi.type == CSCChamberDigiCapture::COMPARATOR) {
+	if (me1a && me11)
+	  compDigis1a[i_layer].push_back(CSCComparatorDigi(digi.channel, digi.comparator,
+							   digi.word));
+	else if (me1a)
+	  compDigis[i_layer].push_back(CSCComparatorDigi(digi.channel + 64,
+							 digi.comparator, digi.word));
+	else
+	  compDigis[i_layer].push_back(CSCComparatorDigi(digi.channel, digi.comparator,
+							 digi.word));
+      }
+    }
+  }
+
+  // Replays one chamber: decodes its digis into times and runs the
+  // requested stage of its TMB on them.
+  void replayChamber(const CSCChamberDigiCapture::Record* digis,
+		     const unsigned int n_digis, CSCMotherboard* tmb,
+		     const bool me11, const Settings& settings,
+		     const Stage stage, Totals& totals) {
+    fillDigis(digis, n_digis, me11, settings);
+    CSCMotherboardME11* tmb11 = me11 ? static_cast<CSCMotherboardME11*>(tmb) : 0;
+
+    const double t0 = now();
+    unsigned long n_stubs = 0;
+    if (stage == STAGE_ALCT) {
+      tmb->alct->clear();
+      tmb->alct->readWireDigis(wireDigis, wire);
+      tmb->alct->run(wire);
+      n_stubs = tmb->alct->getALCTs().size();
+    }
+    else if (stage == STAGE_CLCT) {
+      tmb->clct->clear();
+      tmb->clct->readComparatorDigis(compDigis, halfstrip, distrip);
+      tmb->clct->run(halfstrip, distrip);
+      n_stubs = tmb->clct->getCLCTs().size();
+      if (tmb11) {
+	tmb11->clct1a->clear();
+	tmb11->clct1a->readComparatorDigis(compDigis1a, halfstrip1a, distrip1a);
+	tmb11->clct1a->run(halfstrip1a, distrip1a);
+	n_stubs += tmb11->clct1a->getCLCTs().size();
+      }
+    }
+    else {
+      tmb->alct->readWireDigis(wireDigis, wire);
+      tmb->clct->readComparatorDigis(compDigis, halfstrip, distrip);
+      if (tmb11) {
+	tmb11->clct1a->readComparatorDigis(compDigis1a, halfstrip1a, distrip1a);
+	tmb11->run(wire, halfstrip, distrip, halfstrip1a, distrip1a);
+	n_stubs = tmb11->getLCTs1a().size() + tmb11->getLCTs1b().size();
+      }
+      else {
+	tmb->run(wire, halfstrip, distrip);
+	n_stubs = tmb->getLCTs().size();
+      }
+    }
+    totals.time += now() - t0;
+    totals.chambers++;
+    totals.digis += n_digis;
+    totals.stubs += n_stubs;
+  }
+
+  void usage(const char* prog) {
+    fprintf(stderr,
+	    "Usage: %s <capture file> <config file> [--repeat N] [--stage alct|clct|tmb]\n",
+	    prog);
+  }
+
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {usage(argv[0]); return 1;}
+  const char* fileName = argv[1];
+  const char* configName = argv[2];
+  int n_repeat = 1;
+  Stage stage = STAGE_TMB;
+  for (int i = 3; i < argc; i++) {
+    if (i+1 >= argc) {usage(argv[0]); return 1;}
+    if (strcmp(argv[i], "--repeat") == 0) n_repeat = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--stage") == 0) {
+      const std::string s = argv[++i];
+      if      (s == "alct") stage = STAGE_ALCT;
+      else if (s == "clct") stage = STAGE_CLCT;
+      else if (s == "tmb")  stage = STAGE_TMB;
+      else {usage(argv[0]); return 1;}
+    }
+    else {usage(argv[0]); return 1;}
+  }
+
+  const int fd = open(fileName, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    fprintf(stderr, "Cannot open %s\n", fileName);
+    return 1;
+  }
+  const size_t size = st.st_size;
+  void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    fprintf(stderr, "Cannot map %s\n", fileName);
+    return 1;
+  }
+
+  uint32_t flags = 0;
+  const CSCChamberDigiCapture::Record* first =
+    CSCChamberDigiCapture::firstRecord(data, size, flags);
+  if (!first) {
+    fprintf(stderr, "%s is not a capture file\n", fileName);
+    return 1;
+  }
+  const CSCChamberDigiCapture::Record* end =
+    first + (size - sizeof(CSCChamberDigiCapture::Header))/sizeof(CSCChamberDigiCapture::Record);
+  // The emulator parameters; the ME1/1 mode is that of the capture.
+  Settings settings;
+  settings.smartME1aME1b = flags & CSCChamberDigiCapture::SMART_ME1A_ME1B;
+  edm::ParameterSet conf = edm::readPSetsFrom(configName)->
+    getParameter<edm::ParameterSet>("process").getParameter<edm::ParameterSet>("emulator");
+  edm::ParameterSet commonParams = conf.getParameter<edm::ParameterSet>("commonParam");
+  commonParams.addUntrackedParameter<bool>("smartME1aME1b", settings.smartME1aME1b);
+  conf.addParameter<edm::ParameterSet>("commonParam", commonParams);
+  settings.disableME1a = commonParams.getUntrackedParameter<bool>("disableME1a", false);
+
+  Boards boards;
+  Totals totals;
+  for (int i_repeat = 0; i_repeat < n_repeat; i_repeat++) {
+    const CSCChamberDigiCapture::Record* rec = first;
+    while (rec < end) {
+      if (rec->type != CSCChamberDigiCapture::EVENT) {
+	fprintf(stderr, "Corrupted capture file %s\n", fileName);
+	return 1;
+      }
+      const unsigned int n_chambers = rec->count();
+      ++rec;
+      for (unsigned int i_ch = 0; i_ch < n_chambers && rec < end; i_ch++) {
+	const unsigned int n_digis = rec->count();
+	if (rec->type != CSCChamberDigiCapture::CHAMBER || rec + 1 + n_digis > end) {
+	  fprintf(stderr, "Corrupted capture file %s\n", fileName);
+	  return 1;
+	}
+	const CSCDetId id(rec->rawId);
+	const bool me11 = settings.smartME1aME1b && id.station() == 1 && id.ring() == 1;
+	CSCMotherboard* tmb = board(*rec, settings, conf, boards);
+	replayChamber(rec + 1, n_digis, tmb, me11, settings, stage, totals);
+	rec += 1 + n_digis;
+      }
+      totals.events++;
+    }
+  }
+  munmap(data, size);
+  close(fd);
+  for (Boards::iterator b = boards.begin(); b != boards.end(); ++b) delete b->second;
+
+  const char* stageNames[] = {"ALCT", "CLCT", "TMB"};
+  printf("Replayed %lu events, %lu chambers, %lu digis through %s\n",
+	 totals.events, totals.chambers, totals.digis, stageNames[stage]);
+  if (totals.chambers > 0) {
+    printf("%.0f ns per chamber, %.3g chambers per second, %.3f stubs per chamber\n",
+	   totals.time/totals.chambers, totals.chambers/(totals.time*1.e-9),
+	   static_cast<double>(totals.stubs)/totals.chambers);
+  }
+  return 0;
+}
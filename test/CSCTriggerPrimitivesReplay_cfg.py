@@ -0,0 +1,11 @@
+# Emulator parameters of the boards of CSCTriggerPrimitivesReplay, which
+# should be those of the job the capture file was written by:
+#   CSCTriggerPrimitivesReplay capture.bin CSCTriggerPrimitivesReplay_cfg.py
+# The ME1/1 mode (smartME1aME1b) is taken from the capture file.
+
+import FWCore.ParameterSet.Config as cms
+from L1Trigger.CSCTriggerPrimitives.cscTriggerPrimitiveDigisPostLS1_cfi import cscTriggerPrimitiveDigisPostLS1
+
+process = cms.PSet(
+    emulator = cms.PSet(**cscTriggerPrimitiveDigisPostLS1.parameters_())
+)
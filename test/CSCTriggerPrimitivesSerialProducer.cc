@@ -0,0 +1,81 @@
+//-------------------------------------------------
+//
+//   Class: CSCTriggerPrimitivesSerialProducer
+//
+//   Description: Single-instance run of the trigger primitives emulator,
+//                reference of the multi-stream test.
+//
+//--------------------------------------------------
+
+#include "CSCTriggerPrimitivesSerialProducer.h"
+#include "L1Trigger/CSCTriggerPrimitives/src/CSCTriggerPrimitivesBuilder.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "Geometry/Records/interface/MuonGeometryRecord.h"
+#include "Geometry/CSCGeometry/interface/CSCGeometry.h"
+
+#include "DataFormats/CSCDigi/interface/CSCALCTDigiCollection.h"
+#include "DataFormats/CSCDigi/interface/CSCCLCTDigiCollection.h"
+#include "DataFormats/CSCDigi/interface/CSCCLCTPreTriggerCollection.h"
+#include "DataFormats/CSCDigi/interface/CSCCorrelatedLCTDigiCollection.h"
+
+CSCTriggerPrimitivesSerialProducer::CSCTriggerPrimitivesSerialProducer(
+			     const edm::ParameterSet& conf) :
+  geometryCacheId_(0) {
+  wireDigiToken_ = consumes<CSCWireDigiCollection>(
+		     conf.getParameter<edm::InputTag>("CSCWireDigiProducer"));
+  compDigiToken_ = consumes<CSCComparatorDigiCollection>(
+		     conf.getParameter<edm::InputTag>("CSCComparatorDigiProducer"));
+
+  lctBuilder_.reset(new CSCTriggerPrimitivesBuilder(conf));
+
+  produces<CSCALCTDigiCollection>();
+  produces<CSCCLCTDigiCollection>();
+  produces<CSCCLCTPreTriggerCollection>();
+  produces<CSCCorrelatedLCTDigiCollection>();
+  produces<CSCCorrelatedLCTDigiCollection>("MPCSORTED");
+}
+
+CSCTriggerPrimitivesSerialProducer::~CSCTriggerPrimitivesSerialProducer() {
+}
+
+void CSCTriggerPrimitivesSerialProducer::produce(edm::Event& ev,
+						 const edm::EventSetup& setup) {
+  const MuonGeometryRecord& geomRcd = setup.get<MuonGeometryRecord>();
+  if (geomRcd.cacheIdentifier() != geometryCacheId_) {
+    edm::ESHandle<CSCGeometry> h;
+    geomRcd.get(h);
+    lctBuilder_->setGeometry(h.product(), geomRcd.cacheIdentifier());
+    geometryCacheId_ = geomRcd.cacheIdentifier();
+  }
+
+  edm::Handle<CSCComparatorDigiCollection> compDigis;
+  edm::Handle<CSCWireDigiCollection>       wireDigis;
+  ev.getByToken(compDigiToken_, compDigis);
+  ev.getByToken(wireDigiToken_, wireDigis);
+  if (!wireDigis.isValid() || !compDigis.isValid()) {
+    throw cms::Exception("CSCTriggerPrimitivesSerialProducer")
+      << "Missing wire or comparator digis in event " << ev.id() << "\n";
+  }
+
+  std::auto_ptr<CSCALCTDigiCollection> oc_alct(new CSCALCTDigiCollection);
+  std::auto_ptr<CSCCLCTDigiCollection> oc_clct(new CSCCLCTDigiCollection);
+  std::auto_ptr<CSCCLCTPreTriggerCollection> oc_pretrig(new CSCCLCTPreTriggerCollection);
+  std::auto_ptr<CSCCorrelatedLCTDigiCollection> oc_lct(new CSCCorrelatedLCTDigiCollection);
+  std::auto_ptr<CSCCorrelatedLCTDigiCollection> oc_sorted_lct(new CSCCorrelatedLCTDigiCollection);
+
+  lctBuilder_->build(wireDigis.product(), compDigis.product(),
+		     *oc_alct, *oc_clct, *oc_pretrig, *oc_lct, *oc_sorted_lct);
+
+  ev.put(oc_alct);
+  ev.put(oc_clct);
+  ev.put(oc_pretrig);
+  ev.put(oc_lct);
+  ev.put(oc_sorted_lct,"MPCSORTED");
+}
+
+DEFINE_FWK_MODULE(CSCTriggerPrimitivesSerialProducer);
@@ -0,0 +1,52 @@
+#ifndef CSCTriggerPrimitives_CSCTriggerPrimitivesSerialProducer_h
+#define CSCTriggerPrimitives_CSCTriggerPrimitivesSerialProducer_h
+
+/** \class CSCTriggerPrimitivesSerialProducer
+ *
+ * Test producer which runs the trigger primitives emulator as a single
+ * instance, seeing the events of all the streams one at a time, as the
+ * legacy producer did.  It is the reference of the multi-stream test of
+ * CSCTriggerPrimitivesProducer: given the same parameters, both must make
+ * identical products.
+ *
+ * Only the parameters of the config file are used: no DB parameters, bad
+ * chambers nor region of interest.
+ *
+ */
+
+#include <FWCore/Framework/interface/Frameworkfwd.h>
+#include <FWCore/Framework/interface/one/EDProducer.h>
+#include <FWCore/Framework/interface/Event.h>
+#include <FWCore/Framework/interface/EventSetup.h>
+#include <FWCore/ParameterSet/interface/ParameterSet.h>
+#include <FWCore/Utilities/interface/EDGetToken.h>
+
+#include <DataFormats/CSCDigi/interface/CSCComparatorDigiCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCWireDigiCollection.h>
+
+#include <memory>
+
+class CSCTriggerPrimitivesBuilder;
+
+class CSCTriggerPrimitivesSerialProducer : public edm::one::EDProducer<>
+{
+ public:
+  /// Constructor
+  explicit CSCTriggerPrimitivesSerialProducer(const edm::ParameterSet& conf);
+
+  /// Destructor
+  virtual ~CSCTriggerPrimitivesSerialProducer();
+
+  /// Runs the emulator on one event
+  virtual void produce(edm::Event& ev, const edm::EventSetup& setup);
+
+ private:
+  edm::EDGetTokenT<CSCComparatorDigiCollection> compDigiToken_;
+  edm::EDGetTokenT<CSCWireDigiCollection> wireDigiToken_;
+  // cache identifier of the MuonGeometryRecord last taken
+  unsigned long long geometryCacheId_;
+  // the only builder, shared by all the streams
+  std::unique_ptr<CSCTriggerPrimitivesBuilder> lctBuilder_;
+};
+
+#endif
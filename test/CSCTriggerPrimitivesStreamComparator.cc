@@ -0,0 +1,122 @@
+//-------------------------------------------------
+//
+//   Class: CSCTriggerPrimitivesStreamComparator
+//
+//   Description: Checks that two instances of the trigger primitives
+//                emulator produce identical output in a multi-stream job.
+//
+//--------------------------------------------------
+
+#include "CSCTriggerPrimitivesStreamComparator.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+namespace {
+  template <class D>
+  bool sameDigi(const D& digi, const D& digiRef) {return digi == digiRef;}
+
+  // CSCCLCTPreTrigger has no comparison operator; its BX is all it holds.
+  bool sameDigi(const CSCCLCTPreTrigger& digi, const CSCCLCTPreTrigger& digiRef) {
+    return digi.getBX() == digiRef.getBX();
+  }
+}
+
+CSCTriggerPrimitivesStreamComparator::CSCTriggerPrimitivesStreamComparator(
+			     const edm::ParameterSet& conf) :
+  eventsAnalyzed(0), ndigis(0) {
+  consumeProducts(conf.getUntrackedParameter<edm::InputTag>("CSCLCTProducer"),
+		  tokens_);
+  consumeProducts(conf.getUntrackedParameter<edm::InputTag>("CSCLCTProducerRef"),
+		  tokensRef_);
+}
+
+CSCTriggerPrimitivesStreamComparator::~CSCTriggerPrimitivesStreamComparator() {
+}
+
+void CSCTriggerPrimitivesStreamComparator::analyze(const edm::Event& ev,
+						  const edm::EventSetup& setup) {
+  ++eventsAnalyzed;
+
+  compare(ev, tokens_.alct, tokensRef_.alct, "ALCT");
+  compare(ev, tokens_.clct, tokensRef_.clct, "CLCT");
+  compare(ev, tokens_.pretrig, tokensRef_.pretrig, "CLCT pre-trigger");
+  compare(ev, tokens_.lct, tokensRef_.lct, "TMB LCT");
+  compare(ev, tokens_.mpclct, tokensRef_.mpclct, "MPC LCT");
+}
+
+// The tag gives the module label; the instance names are those of the
+// producer.
+void CSCTriggerPrimitivesStreamComparator::consumeProducts(
+			     const edm::InputTag& tag, Tokens& tokens) {
+  const std::string& label = tag.label();
+  const std::string& process = tag.process();
+  tokens.alct =
+    consumes<CSCALCTDigiCollection>(edm::InputTag(label, "", process));
+  tokens.clct =
+    consumes<CSCCLCTDigiCollection>(edm::InputTag(label, "", process));
+  tokens.pretrig =
+    consumes<CSCCLCTPreTriggerCollection>(edm::InputTag(label, "", process));
+  tokens.lct =
+    consumes<CSCCorrelatedLCTDigiCollection>(edm::InputTag(label, "", process));
+  tokens.mpclct =
+    consumes<CSCCorrelatedLCTDigiCollection>(edm::InputTag(label, "MPCSORTED", process));
+}
+
+template <class T>
+void CSCTriggerPrimitivesStreamComparator::compare(const edm::Event& ev,
+						   const edm::EDGetTokenT<T>& token,
+						   const edm::EDGetTokenT<T>& tokenRef,
+						   const char* what) {
+  edm::Handle<T> digis, digisRef;
+  ev.getByToken(token, digis);
+  ev.getByToken(tokenRef, digisRef);
+
+  // Both instances see the same input, so both products must be there.
+  if (!digis.isValid() || !digisRef.isValid()) {
+    throw cms::Exception("CSCTriggerPrimitivesStreamComparator")
+      << "Missing " << what << " collection in event " << ev.id() << "\n";
+  }
+
+  typename T::DigiRangeIterator det = digis->begin();
+  typename T::DigiRangeIterator detRef = digisRef->begin();
+  for (; det != digis->end() && detRef != digisRef->end(); ++det, ++detRef) {
+    if ((*det).first != (*detRef).first) {
+      throw cms::Exception("CSCTriggerPrimitivesStreamComparator")
+	<< what << " chambers differ in event " << ev.id() << ": "
+	<< (*det).first << " vs " << (*detRef).first << "\n";
+    }
+    typename T::const_iterator digi = (*det).second.first;
+    typename T::const_iterator digiRef = (*detRef).second.first;
+    for (; digi != (*det).second.second &&
+	   digiRef != (*detRef).second.second; ++digi, ++digiRef) {
+      if (!sameDigi(*digi, *digiRef)) {
+	throw cms::Exception("CSCTriggerPrimitivesStreamComparator")
+	  << what << "s differ in event " << ev.id()
+	  << " in chamber " << (*det).first << ":\n"
+	  << *digi << "\n" << *digiRef << "\n";
+      }
+      ndigis++;
+    }
+    if (digi != (*det).second.second || digiRef != (*detRef).second.second) {
+      throw cms::Exception("CSCTriggerPrimitivesStreamComparator")
+	<< "Numbers of " << what << "s differ in event " << ev.id()
+	<< " in chamber " << (*det).first << "\n";
+    }
+  }
+  if (det != digis->end() || detRef != digisRef->end()) {
+    throw cms::Exception("CSCTriggerPrimitivesStreamComparator")
+      << "Numbers of chambers with " << what << "s differ in event "
+      << ev.id() << "\n";
+  }
+}
+
+void CSCTriggerPrimitivesStreamComparator::endJob() {
+  edm::LogInfo("CSCTriggerPrimitivesStreamComparator")
+    << "Compared " << ndigis << " digis in " << eventsAnalyzed
+    << " events: no differences found";
+}
+
+DEFINE_FWK_MODULE(CSCTriggerPrimitivesStreamComparator);
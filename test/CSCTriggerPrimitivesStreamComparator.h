@@ -0,0 +1,66 @@
+#ifndef CSCTriggerPrimitives_CSCTriggerPrimitivesStreamComparator_h
+#define CSCTriggerPrimitives_CSCTriggerPrimitivesStreamComparator_h
+
+/** \class CSCTriggerPrimitivesStreamComparator
+ *
+ * Test analyzer which checks that two instances of the trigger primitives
+ * emulator run in the same job on the same input, typically the stream
+ * module and the single-instance CSCTriggerPrimitivesSerialProducer,
+ * produce identical ALCTs, CLCTs, CLCT pre-triggers, TMB LCTs and MPC
+ * LCTs.  Throws on the first difference.
+ *
+ */
+
+#include <FWCore/Framework/interface/Frameworkfwd.h>
+#include <FWCore/Framework/interface/one/EDAnalyzer.h>
+#include <FWCore/Framework/interface/Event.h>
+#include <FWCore/Framework/interface/EventSetup.h>
+#include <FWCore/ParameterSet/interface/ParameterSet.h>
+#include <FWCore/Utilities/interface/InputTag.h>
+#include <FWCore/Utilities/interface/EDGetToken.h>
+#include <DataFormats/CSCDigi/interface/CSCALCTDigiCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCCLCTDigiCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCCLCTPreTriggerCollection.h>
+#include <DataFormats/CSCDigi/interface/CSCCorrelatedLCTDigiCollection.h>
+
+class CSCTriggerPrimitivesStreamComparator : public edm::one::EDAnalyzer<>
+{
+ public:
+  /// Constructor
+  explicit CSCTriggerPrimitivesStreamComparator(const edm::ParameterSet& conf);
+
+  /// Destructor
+  virtual ~CSCTriggerPrimitivesStreamComparator();
+
+  /// Compares the products of the two emulator instances
+  virtual void analyze(const edm::Event& event, const edm::EventSetup& setup);
+
+  /// Prints the summary
+  virtual void endJob();
+
+ private:
+  /// Tokens of the collections of one emulator run.
+  struct Tokens {
+    edm::EDGetTokenT<CSCALCTDigiCollection> alct;
+    edm::EDGetTokenT<CSCCLCTDigiCollection> clct;
+    edm::EDGetTokenT<CSCCLCTPreTriggerCollection> pretrig;
+    edm::EDGetTokenT<CSCCorrelatedLCTDigiCollection> lct;
+    edm::EDGetTokenT<CSCCorrelatedLCTDigiCollection> mpclct;
+  };
+
+  /// Declares the collections of the emulator run of the given tag.
+  void consumeProducts(const edm::InputTag& tag, Tokens& tokens);
+
+  /// Compares one collection of the two emulator runs.
+  template <class T>
+  void compare(const edm::Event& ev, const edm::EDGetTokenT<T>& token,
+	       const edm::EDGetTokenT<T>& tokenRef, const char* what);
+
+  int eventsAnalyzed;       // event number
+  int ndigis;               // number of compared digis
+
+  Tokens tokens_;    // emulator under test
+  Tokens tokensRef_; // reference emulator
+};
+
+#endif
@@ -0,0 +1,92 @@
+# Concurrency test of the CSC trigger primitives emulator: in one job on
+# 4 threads and 4 streams, the products of the stream module, one
+# instance per stream, are required to be identical event by event to
+# those of a single emulator instance, CSCTriggerPrimitivesSerialProducer,
+# which sees the events of all the streams one at a time as with
+# numberOfStreams = 1.  The input is made by CSCSyntheticDigiProducer on
+# the ideal geometry, so neither an input file nor a global tag is needed:
+#   cmsRun CSCTriggerPrimitivesStreamsTest_cfg.py
+#
+# engine selects the chamber loop of the stream module under test, the
+# reference always running the serial one:
+#   serial   - chambers run one after the other (default)
+#   parallel - chambers run concurrently (runParallel)
+#   sparse   - chambers having digis run concurrently (runParallel and
+#              sparseDispatch)
+# With more threads than streams, as in
+#   cmsRun CSCTriggerPrimitivesStreamsTest_cfg.py engine=parallel threads=8 streams=2
+# the chambers of one event are spread over several threads, and so are
+# the per-thread scratch arenas of the processors.
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('threads', 4, VarParsing.multiplicity.singleton,
+                 VarParsing.varType.int, "number of threads")
+options.register('streams', 4, VarParsing.multiplicity.singleton,
+                 VarParsing.varType.int, "number of streams")
+options.register('engine', 'serial', VarParsing.multiplicity.singleton,
+                 VarParsing.varType.string, "serial, parallel or sparse")
+options.maxEvents = 40
+options.parseArguments()
+
+process = cms.Process("CSCTriggerPrimitivesStreams")
+
+process.source = cms.Source("EmptySource")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(options.streams)
+)
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+
+# es_source of ideal geometry
+# ===========================
+process.load("Geometry.MuonCommonData.muonIdealGeometryXML_cfi")
+process.load("Geometry.MuonNumbering.muonNumberingInitialization_cfi")
+process.load("Geometry.CSCGeometryBuilder.cscGeometry_cfi")
+process.CSCGeometryESModule.useDDD = True
+process.CSCGeometryESModule.applyAlignment = False
+
+# Synthetic digis, under the label the emulator reads
+# ===================================================
+process.simMuonCSCDigis = cms.EDProducer("CSCSyntheticDigiProducer",
+    meanMuons = cms.untracked.double(0.05),
+    neutronHits = cms.untracked.double(0.1),
+    pileup = cms.untracked.double(50.),
+    seed = cms.untracked.uint32(1)
+)
+
+# CSC Trigger Primitives: stream module under test, and the same
+# parameters in a single instance as reference
+# =============================================
+process.load("L1Trigger.CSCTriggerPrimitives.cscTriggerPrimitiveDigisPostLS1_cfi")
+tp = process.cscTriggerPrimitiveDigisPostLS1
+
+process.cscTriggerPrimitiveDigisSerial = cms.EDProducer(
+    "CSCTriggerPrimitivesSerialProducer", **tp.parameters_())
+
+if options.engine in ('parallel', 'sparse'):
+    tp.runParallel = True
+if options.engine == 'sparse':
+    tp.sparseDispatch = True
+if options.engine not in ('serial', 'parallel', 'sparse'):
+    raise Exception("unknown engine " + options.engine)
+
+process.streamComparator = cms.EDAnalyzer("CSCTriggerPrimitivesStreamComparator",
+    CSCLCTProducer = cms.untracked.InputTag("cscTriggerPrimitiveDigisPostLS1"),
+    CSCLCTProducerRef = cms.untracked.InputTag("cscTriggerPrimitiveDigisSerial")
+)
+
+# Scheduler path
+# ==============
+process.p = cms.Path(process.simMuonCSCDigis *
+                     process.cscTriggerPrimitiveDigisPostLS1 *
+                     process.cscTriggerPrimitiveDigisSerial *
+                     process.streamComparator)
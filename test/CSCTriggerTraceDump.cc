@@ -0,0 +1,124 @@
+//-------------------------------------------------
+//
+//   Program: CSCTriggerTraceDump
+//
+//   Description: Prints the trace of the board decisions of the chambers
+//                listed in the traceChambers parameter of the producer,
+//                as written to traceFile.  Each record is printed on one
+//                line with the event it belongs to; the records of each
+//                thread come in the order they were made, oldest first.
+//
+//   Usage: CSCTriggerTraceDump <trace file> [--chamber ME+1/2/13]
+//
+//--------------------------------------------------
+
+#include <L1Trigger/CSCTriggerPrimitives/src/CSCTriggerTrace.h>
+
+#include <DataFormats/MuonDetId/interface/CSCDetId.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+  // Chamber name like "ME+1/2/13".
+  std::string chamberName(const CSCDetId& id) {
+    char name[32];
+    snprintf(name, sizeof(name), "ME%c%d/%d/%d", (id.endcap() == 1) ? '+' : '-',
+	     id.station(), id.ring(), id.chamber());
+    return name;
+  }
+
+  // Raw id of the chamber the builder records the events of; ME1/a
+  // records belong to the events of ME1/1.
+  uint32_t eventChamber(const CSCDetId& id) {
+    const int ring = (id.station() == 1 && id.ring() == 4) ? 1 : id.ring();
+    return CSCDetId(id.endcap(), id.station(), ring, id.chamber(), 0).rawId();
+  }
+
+  void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s <trace file> [--chamber ME+1/2/13]\n", prog);
+  }
+
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {usage(argv[0]); return 1;}
+  const char* fileName = argv[1];
+  std::string chamber;
+  for (int i = 2; i < argc; i++) {
+    if (i+1 >= argc) {usage(argv[0]); return 1;}
+    if (strcmp(argv[i], "--chamber") == 0) chamber = argv[++i];
+    else {usage(argv[0]); return 1;}
+  }
+
+  const int fd = open(fileName, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    fprintf(stderr, "Cannot open %s\n", fileName);
+    return 1;
+  }
+  const size_t size = st.st_size;
+  void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    fprintf(stderr, "Cannot map %s\n", fileName);
+    return 1;
+  }
+
+  const CSCTriggerTrace::Record* first = CSCTriggerTrace::firstRecord(data, size);
+  if (!first) {
+    fprintf(stderr, "%s is not a trace file\n", fileName);
+    return 1;
+  }
+  const CSCTriggerTrace::Record* end =
+    first + (size - sizeof(CSCTriggerTrace::Header))/sizeof(CSCTriggerTrace::Record);
+
+  const char* sourceNames[] = {"BUILDER", "ALCT", "CLCT", "TMB"};
+  const char* typeNames[] = {"EVENT", "PRETRIGGER", "PATTERN_HIT",
+			     "GHOST_CANCEL", "LATCH", "CORRELATION"};
+  const char* keyNames[] = {"key", "key", "key", "key", "key", "wg"};
+  const char* aNames[] = {"a", "pid", "pattern", "type", "pattern", "hs"};
+  const char* bNames[] = {"event", "nhits", "quality", "by", "quality", "quality"};
+
+  // Event of each chamber, from its last EVENT record; the records of a
+  // thread made before it belong to an event whose start was overwritten.
+  std::map<uint32_t, uint32_t> events;
+  for (const CSCTriggerTrace::Record* rec = first; rec < end; ++rec) {
+    if (rec->source > CSCTriggerTrace::TMB || rec->type > CSCTriggerTrace::CORRELATION) {
+      fprintf(stderr, "Corrupted trace file %s\n", fileName);
+      return 1;
+    }
+    if (rec->rawId == 0) {
+      // Start of the records of another thread.
+      events.clear();
+      continue;
+    }
+    const CSCDetId id(rec->rawId);
+    if (rec->type == CSCTriggerTrace::EVENT) {
+      events[eventChamber(id)] = rec->b;
+      continue;
+    }
+    const std::string name = chamberName(id);
+    if (!chamber.empty() && name != chamber) continue;
+
+    std::map<uint32_t, uint32_t>::const_iterator ev = events.find(eventChamber(id));
+    if (ev != events.end()) printf("event %10u ", ev->second);
+    else                    printf("event %10s ", "?");
+    // The CLCT key half-strips are shown with the stagger, as used by the
+    // pattern finder, except in CORRELATION records.
+    printf("%-11s %-4s %-12s bx %2d %s %3u %s %2u %s %u\n",
+	   name.c_str(), sourceNames[rec->source], typeNames[rec->type],
+	   rec->bx, keyNames[rec->type], rec->key, aNames[rec->type], rec->a,
+	   bNames[rec->type], rec->b);
+  }
+  munmap(data, size);
+  close(fd);
+  return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef CSCTriggerPrimitives_Baseline_CSCTriggerPrimitivesProducer_h
+#define CSCTriggerPrimitives_Baseline_CSCTriggerPrimitivesProducer_h
+
+/** \class CSCTriggerPrimitivesProducer
+ *
+ * Implementation of the local Level-1 Cathode Strip Chamber trigger.
+ * Simulates functionalities of the anode and cathode Local Charged Tracks
+ * (LCT) processors, of the Trigger Mother Board (TMB), and of the Muon Port
+ * Card (MPC).
+ *
+ * Input to the simulation are collections of the CSC wire and comparator
+ * digis.
+ *
+ * Produces four collections of the Level-1 CSC Trigger Primitives (track
+ * stubs, or LCTs): anode LCTs (ALCTs), cathode LCTs (CLCTs), correlated
+ * LCTs at TMB, and correlated LCTs at MPC.
+ *
+ * This directory holds a frozen copy of the emulator (src/ and plugins/ of
+ * the package) as it was before its performance rewrites, in namespace
+ * csctp_baseline.  It is registered as CSCTriggerPrimitivesBaselineProducer
+ * and writes the golden files of CSCTriggerPrimitivesGoldenFile, so that
+ * the reference of the bit-exact test does not come from the code it
+ * tests.  Apart from the include paths and the namespace, the only
+ * changes are that the bad chambers are not fetched unless they are
+ * checked, and that the digi inputs are declared with consumes().  Do not
+ * update these files with the emulator.
+ *
+ * \author Slava Valuev, UCLA.
+ *
+ * $Id: CSCTriggerPrimitivesProducer.h,v 1.4.2.1 2012/05/16 00:31:24 khotilov Exp $
+ *
+ */
+
+#include <FWCore/Framework/interface/Frameworkfwd.h>
+#include <FWCore/Framework/interface/EDProducer.h>
+#include <FWCore/Framework/interface/Event.h>
+#include <FWCore/ParameterSet/interface/ParameterSet.h>
+#include <FWCore/Utilities/interface/InputTag.h>
+
+namespace csctp_baseline {
+
+class CSCTriggerPrimitivesBuilder;
+
+class CSCTriggerPrimitivesProducer : public edm::EDProducer
+{
+ public:
+  explicit CSCTriggerPrimitivesProducer(const edm::ParameterSet&);
+  ~CSCTriggerPrimitivesProducer();
+
+  //virtual void beginRun(const edm::EventSetup& setup);
+  virtual void produce(edm::Event&, const edm::EventSetup&);
+
+ private:
+  int iev; // event number
+  edm::InputTag compDigiProducer_;
+  edm::InputTag wireDigiProducer_;
+  // swich to force the use of parameters from config file rather then from DB
+  bool debugParameters_;
+  // switch to for enabling checking against the list of bad chambers
+  bool checkBadChambers_;
+  CSCTriggerPrimitivesBuilder* lctBuilder_;
+};
+
+}
+
+#endif
@@ -0,0 +1,28 @@
+#!/bin/bash
+#
+# Bit-exact regression test of the CSC trigger primitives emulator on
+# synthetic digis: for each board configuration and read-out window,
+# records the outputs of the baseline emulator, then compares those of
+# each engine of the emulator to them, the concurrent ones on several
+# threads and streams.
+
+function die { echo $1: status $2 ; exit $2; }
+
+CFG=${LOCAL_TEST_DIR}/CSCTriggerPrimitivesGolden_cfg.py
+
+for config in tmb07 mtcc slhc smartME1aME1b; do
+  for readout in standard full; do
+    cmsRun ${CFG} mode=write config=${config} readout=${readout} \
+      || die "Failure writing the golden file of ${config} ${readout}" $?
+    for engine in reference bitParallel; do
+      cmsRun ${CFG} mode=compare config=${config} readout=${readout} \
+        engine=${engine} \
+        || die "Failure comparing ${engine} to the golden file of ${config} ${readout}" $?
+    done
+    for engine in parallel sparse; do
+      cmsRun ${CFG} mode=compare config=${config} readout=${readout} \
+        engine=${engine} threads=4 streams=2 \
+        || die "Failure comparing ${engine} to the golden file of ${config} ${readout}" $?
+    done
+  done
+done
@@ -0,0 +1,17 @@
+#!/bin/bash
+#
+# Concurrency test of the CSC trigger primitives emulator: the stream
+# module run on several streams must reproduce a single emulator instance,
+# first with the serial chamber loop, then with the concurrent ones on more
+# threads than streams, so that the chambers of an event are shared out.
+
+function die { echo $1: status $2 ; exit $2; }
+
+CFG=${LOCAL_TEST_DIR}/CSCTriggerPrimitivesStreamsTest_cfg.py
+
+cmsRun ${CFG} engine=serial threads=4 streams=4 \
+  || die "Failure comparing the stream module to a single instance" $?
+for engine in parallel sparse; do
+  cmsRun ${CFG} engine=${engine} threads=8 streams=2 \
+    || die "Failure comparing the ${engine} chamber loop to a single instance" $?
+done